@@ -0,0 +1,105 @@
+/** Host stand-in for the Logue SDK biquad filter (dsp/biquad.hpp).
+ *
+ *  Provides the dsp::BiQuad interface with the same coefficient conventions as the SDK: feed-forward
+ *  terms ff0..ff2 and feedback terms fb1..fb2, with a transposed direct form II process loop.
+ */
+#pragma once
+
+#include <math.h>
+#include "utils/float_math.h"
+
+namespace dsp
+{
+    struct BiQuad
+    {
+        struct Coeffs
+        {
+            float ff0 { 0.0f };
+            float ff1 { 0.0f };
+            float ff2 { 0.0f };
+            float fb1 { 0.0f };
+            float fb2 { 0.0f };
+
+            /** Return the bilinear pre-warped frequency parameter for a normalized cutoff (fc / fs).
+             */
+            static inline float wc(const float fc, const float fsrecip)
+            {
+                return tanf(M_PI_F * fc * fsrecip);
+            }
+
+            inline void setFOLP(const float k)
+            {
+                const float kp1 = k + 1.0f;
+                ff0 = k / kp1;
+                ff1 = ff0;
+                ff2 = 0.0f;
+                fb1 = (k - 1.0f) / kp1;
+                fb2 = 0.0f;
+            }
+
+            inline void setFOHP(const float k)
+            {
+                const float kp1 = k + 1.0f;
+                ff0 = 1.0f / kp1;
+                ff1 = -ff0;
+                ff2 = 0.0f;
+                fb1 = (k - 1.0f) / kp1;
+                fb2 = 0.0f;
+            }
+
+            inline void setSOLP(const float k, const float q)
+            {
+                const float kk = k * k;
+                const float kkq = kk * q;
+                const float d = 1.0f / (kkq + k + q);
+                ff0 = kkq * d;
+                ff1 = 2.0f * ff0;
+                ff2 = ff0;
+                fb1 = 2.0f * q * (kk - 1.0f) * d;
+                fb2 = (kkq - k + q) * d;
+            }
+
+            inline void setSOHP(const float k, const float q)
+            {
+                const float kk = k * k;
+                const float kkq = kk * q;
+                const float d = 1.0f / (kkq + k + q);
+                ff0 = q * d;
+                ff1 = -2.0f * ff0;
+                ff2 = ff0;
+                fb1 = 2.0f * q * (kk - 1.0f) * d;
+                fb2 = (kkq - k + q) * d;
+            }
+        };
+
+        Coeffs mCoeffs;
+        float mZ1 { 0.0f };
+        float mZ2 { 0.0f };
+
+        inline void flush()
+        {
+            mZ1 = 0.0f;
+            mZ2 = 0.0f;
+        }
+
+        /** First order process (ignores ff2/fb2).
+         */
+        inline float process_fo(const float xn)
+        {
+            const float acc = mCoeffs.ff0 * xn + mZ1;
+            mZ1 = mCoeffs.ff1 * xn - mCoeffs.fb1 * acc;
+            return acc;
+        }
+
+        /** Second order process.
+         */
+        inline float process_so(const float xn)
+        {
+            const float acc = mCoeffs.ff0 * xn + mZ1;
+            mZ1 = mCoeffs.ff1 * xn + mZ2 - mCoeffs.fb1 * acc;
+            mZ2 = mCoeffs.ff2 * xn - mCoeffs.fb2 * acc;
+            return acc;
+        }
+    };
+
+}   // namespace
@@ -0,0 +1,191 @@
+/** Host stand-in for the Logue SDK oscillator API (osc_api.h).
+ *
+ *  This mirrors the inline functions, constants and table layouts of the SDK header so that the
+ *  demo sources compile unchanged on a desktop host. The lookup tables and the out-of-line functions
+ *  that live in the synth firmware are supplied by panel-host/lib/osc_api.cpp.
+ *
+ *  The interpolation arithmetic below is a line-for-line match of the SDK inline functions. The
+ *  table contents are regenerated from their defining equations (see osc_api.cpp), so they follow
+ *  the firmware data closely but are not guaranteed to be bit-identical to it.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "utils/float_math.h"
+#include "utils/int_math.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // API identification (normally at fixed flash addresses, see ld/osc_api.syms).
+    extern const uint32_t k_osc_api_version;
+    extern const uint32_t k_osc_api_platform;
+
+
+    // Sample rate.
+#define k_samplerate                (48000)
+#define k_samplerate_recipf         (2.08333333333333e-005f)
+
+
+    // Note to frequency conversion.
+#define k_note_mod_fscale           (0.00392156862745098f)
+#define k_note_max_hz               (23679.643054f)
+#define k_midi_to_hz_size           (152)
+
+    extern const float midi_to_hz_lut_f[k_midi_to_hz_size];
+
+    __fast_inline float osc_notehzf(uint8_t note)
+    {
+        return midi_to_hz_lut_f[clipmaxu32(note, k_midi_to_hz_size - 1)];
+    }
+
+    __fast_inline float osc_w0f_for_note(uint8_t note, uint8_t mod)
+    {
+        const float f0 = osc_notehzf(note);
+        const float f1 = osc_notehzf(note + 1);
+        const float f = clipmaxf(linintf(mod * k_note_mod_fscale, f0, f1), k_note_max_hz);
+        return f * k_samplerate_recipf;
+    }
+
+
+    // Sine wave (half period stored).
+#define k_wt_sine_size_exp          (7)
+#define k_wt_sine_size              (1U << k_wt_sine_size_exp)
+#define k_wt_sine_u32shift          (24)
+#define k_wt_sine_frrecip           (5.96046447753906e-008f)
+#define k_wt_sine_mask              (k_wt_sine_size - 1)
+#define k_wt_sine_lut_size          (k_wt_sine_size + 1)
+
+    extern const float wt_sine_lut_f[k_wt_sine_lut_size];
+
+    __fast_inline float osc_sinf(float x)
+    {
+        const float p = x - (uint32_t)x;
+        const float x0f = 2.f * p * k_wt_sine_size;
+        const uint32_t x0p = (uint32_t)x0f;
+        const uint32_t x0 = x0p & k_wt_sine_mask;
+        const uint32_t x1 = (x0 + 1) & k_wt_sine_mask;
+        const float y0 = linintf(x0f - x0p, wt_sine_lut_f[x0], wt_sine_lut_f[x1]);
+        return (x0p < k_wt_sine_size) ? y0 : -y0;
+    }
+
+    __fast_inline float osc_cosf(float x)
+    {
+        return osc_sinf(x + 0.25f);
+    }
+
+
+    // Band-limited wave tables. Each table holds one half period (the waves are odd-symmetric), and
+    // there are k_wt_*_notes_cnt tables of decreasing harmonic content. The wt_*_notes[] arrays hold
+    // the highest MIDI note that each table can render without aliasing.
+#define OSC_API_DECLARE_WAVE(_name)                                                                         \
+    extern const uint8_t wt_##_name##_notes[k_wt_##_name##_notes_cnt];                                      \
+    extern const float wt_##_name##_lut_f[k_wt_##_name##_lut_tsize];                                        \
+    float _osc_bl_##_name##_idx(float note);                                                                \
+                                                                                                            \
+    __fast_inline float osc_##_name##f(float x)                                                             \
+    {                                                                                                       \
+        const float p = x - (uint32_t)x;                                                                    \
+        const float x0f = 2.f * p * k_wt_##_name##_size;                                                    \
+        const uint32_t x0p = (uint32_t)x0f;                                                                 \
+        uint32_t x0 = x0p, x1 = x0p + 1;                                                                    \
+        float sign = 1.f;                                                                                   \
+        if (x0p >= k_wt_##_name##_size) {                                                                   \
+            x0 = k_wt_##_name##_size - (x0p & k_wt_##_name##_mask);                                         \
+            x1 = x0 - 1;                                                                                    \
+            sign = -1.f;                                                                                    \
+        }                                                                                                   \
+        const float y0 = linintf(x0f - x0p, wt_##_name##_lut_f[x0], wt_##_name##_lut_f[x1]);                \
+        return sign * y0;                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    __fast_inline float osc_bl_##_name##f(float x, uint8_t idx)                                             \
+    {                                                                                                       \
+        const float p = x - (uint32_t)x;                                                                    \
+        const float x0f = 2.f * p * k_wt_##_name##_size;                                                    \
+        const uint32_t x0p = (uint32_t)x0f;                                                                 \
+        uint32_t x0 = x0p, x1 = x0p + 1;                                                                    \
+        float sign = 1.f;                                                                                   \
+        if (x0p >= k_wt_##_name##_size) {                                                                   \
+            x0 = k_wt_##_name##_size - (x0p & k_wt_##_name##_mask);                                         \
+            x1 = x0 - 1;                                                                                    \
+            sign = -1.f;                                                                                    \
+        }                                                                                                   \
+        const float* wt = &wt_##_name##_lut_f[idx * k_wt_##_name##_lut_size];                               \
+        const float y0 = linintf(x0f - x0p, wt[x0], wt[x1]);                                                \
+        return sign * y0;                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    __fast_inline float osc_bl2_##_name##f(float x, float idx)                                              \
+    {                                                                                                       \
+        const float p = x - (uint32_t)x;                                                                    \
+        const float x0f = 2.f * p * k_wt_##_name##_size;                                                    \
+        const uint32_t x0p = (uint32_t)x0f;                                                                 \
+        uint32_t x0 = x0p, x1 = x0p + 1;                                                                    \
+        float sign = 1.f;                                                                                   \
+        if (x0p >= k_wt_##_name##_size) {                                                                   \
+            x0 = k_wt_##_name##_size - (x0p & k_wt_##_name##_mask);                                         \
+            x1 = x0 - 1;                                                                                    \
+            sign = -1.f;                                                                                    \
+        }                                                                                                   \
+        const float fr = x0f - x0p;                                                                         \
+        const uint32_t idxi = (uint32_t)idx;                                                                \
+        const float* wt = &wt_##_name##_lut_f[idxi * k_wt_##_name##_lut_size];                              \
+        const float y0 = linintf(fr, wt[x0], wt[x1]);                                                       \
+        wt += k_wt_##_name##_lut_size;                                                                      \
+        const float y1 = linintf(fr, wt[x0], wt[x1]);                                                       \
+        return sign * linintf(idx - idxi, y0, y1);                                                          \
+    }                                                                                                       \
+                                                                                                            \
+    __fast_inline float osc_bl_##_name##_idx(float note)                                                    \
+    {                                                                                                       \
+        return _osc_bl_##_name##_idx(note);                                                                 \
+    }
+
+#define k_wt_saw_size_exp           (6)
+#define k_wt_saw_size               (1U << k_wt_saw_size_exp)
+#define k_wt_saw_u32shift           (25)
+#define k_wt_saw_frrecip            (2.98023223876953e-008f)
+#define k_wt_saw_mask               (k_wt_saw_size - 1)
+#define k_wt_saw_lut_size           (k_wt_saw_size + 1)
+#define k_wt_saw_notes_cnt          (7)
+#define k_wt_saw_lut_tsize          (k_wt_saw_notes_cnt * k_wt_saw_lut_size)
+
+#define k_wt_sqr_size_exp           (6)
+#define k_wt_sqr_size               (1U << k_wt_sqr_size_exp)
+#define k_wt_sqr_u32shift           (25)
+#define k_wt_sqr_frrecip            (2.98023223876953e-008f)
+#define k_wt_sqr_mask               (k_wt_sqr_size - 1)
+#define k_wt_sqr_lut_size           (k_wt_sqr_size + 1)
+#define k_wt_sqr_notes_cnt          (7)
+#define k_wt_sqr_lut_tsize          (k_wt_sqr_notes_cnt * k_wt_sqr_lut_size)
+
+#define k_wt_par_size_exp           (6)
+#define k_wt_par_size               (1U << k_wt_par_size_exp)
+#define k_wt_par_u32shift           (25)
+#define k_wt_par_frrecip            (2.98023223876953e-008f)
+#define k_wt_par_mask               (k_wt_par_size - 1)
+#define k_wt_par_lut_size           (k_wt_par_size + 1)
+#define k_wt_par_notes_cnt          (7)
+#define k_wt_par_lut_tsize          (k_wt_par_notes_cnt * k_wt_par_lut_size)
+
+    OSC_API_DECLARE_WAVE(saw)
+    OSC_API_DECLARE_WAVE(sqr)
+    OSC_API_DECLARE_WAVE(par)
+
+#undef OSC_API_DECLARE_WAVE
+
+
+    // Random numbers and identification.
+    uint32_t _osc_mcu_hash(void);
+    uint32_t _osc_rand(void);
+    float _osc_white(void);
+
+    __fast_inline uint32_t osc_mcu_hash(void) { return _osc_mcu_hash(); }
+    __fast_inline uint32_t osc_rand(void) { return _osc_rand(); }
+    __fast_inline float osc_white(void) { return _osc_white(); }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+/** Host stand-in for the Logue SDK user oscillator interface (userosc.h).
+ */
+#pragma once
+
+#include <stdint.h>
+#include "userprg.h"
+#include "osc_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Parameter identifiers passed to OSC_PARAM().
+     */
+    typedef enum {
+        k_user_osc_param_id1 = 0,
+        k_user_osc_param_id2,
+        k_user_osc_param_id3,
+        k_user_osc_param_id4,
+        k_user_osc_param_id5,
+        k_user_osc_param_id6,
+        k_user_osc_param_shape,
+        k_user_osc_param_shiftshape,
+        k_num_user_osc_param_id
+    } user_osc_param_id_t;
+
+    /** Oscillator parameters passed to OSC_CYCLE(), OSC_NOTEON() etc. Layout matches the firmware.
+     */
+    typedef struct user_osc_param {
+        int32_t  shape_lfo;                 ///< Shape LFO modulation (Q31).
+        uint16_t pitch;                     ///< Pitch: high byte note number, low byte fine (0-255).
+        uint16_t cutoff;                    ///< Current cutoff value (0x0000-0x1fff).
+        uint16_t resonance;                 ///< Current resonance value (0x0000-0x1fff).
+        uint16_t reserved0[3];
+    } user_osc_param_t;
+
+    /** Convert a 10 bit parameter value to float [0.0, 1.0].
+     */
+    __fast_inline float param_val_to_f32(uint16_t x) { return (float)x * 9.77517106549365e-004f; }
+
+    // Entry points. The unit code implements these via the OSC_* macros.
+    void _entry(uint32_t platform, uint32_t api);
+    void _hook_init(uint32_t platform, uint32_t api);
+    void _hook_cycle(const user_osc_param_t* const params, int32_t* yn, const uint32_t frames);
+    void _hook_on(const user_osc_param_t* const params);
+    void _hook_off(const user_osc_param_t* const params);
+    void _hook_mute(const user_osc_param_t* const params);
+    void _hook_value(uint16_t value);
+    void _hook_param(uint16_t index, uint16_t value);
+
+#define OSC_INIT    __attribute__((used)) _hook_init
+#define OSC_CYCLE   __attribute__((used)) _hook_cycle
+#define OSC_NOTEON  __attribute__((used)) _hook_on
+#define OSC_NOTEOFF __attribute__((used)) _hook_off
+#define OSC_MUTE    __attribute__((used)) _hook_mute
+#define OSC_VALUE   __attribute__((used)) _hook_value
+#define OSC_PARAM   __attribute__((used)) _hook_param
+
+#ifdef __cplusplus
+}
+#endif
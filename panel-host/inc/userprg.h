@@ -0,0 +1,47 @@
+/** Host stand-in for the Logue SDK user program definitions (userprg.h).
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Target platform and module identifiers. The platform is in bits [15:8], the module in bits [7:0].
+     */
+    typedef enum {
+        k_user_target_prologue          = (1U << 8),
+        k_user_target_miniloguexd       = (2U << 8),
+        k_user_target_nutektdigital     = (3U << 8),
+        k_user_target_host              = (0xffU << 8),     ///< Host builds only; not a firmware value.
+    } user_target_platform_t;
+
+    typedef enum {
+        k_user_module_global            = 0U,
+        k_user_module_modfx,
+        k_user_module_delfx,
+        k_user_module_revfx,
+        k_user_module_osc,
+        k_num_user_modules,
+    } user_target_module_t;
+
+#define k_user_target_prologue_osc          (k_user_target_prologue | k_user_module_osc)
+#define k_user_target_miniloguexd_osc       (k_user_target_miniloguexd | k_user_module_osc)
+#define k_user_target_nutektdigital_osc     (k_user_target_nutektdigital | k_user_module_osc)
+#define k_user_target_host_osc              (k_user_target_host | k_user_module_osc)
+
+    /** API version, encoded as major [23:16], minor [15:8], patch [7:0].
+     */
+    typedef enum {
+        k_user_api_1_0_0                = ((1U << 16) | (0U << 8) | (0U)),
+        k_user_api_1_1_0                = ((1U << 16) | (1U << 8) | (0U)),
+    } user_api_version_t;
+
+#define USER_API_VERSION                    (k_user_api_1_1_0)
+#define USER_TARGET_PLATFORM                (k_user_target_host)
+#define USER_TARGET_MODULE                  (k_user_module_osc)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+/** Host stand-in for the Logue SDK float utility functions (utils/float_math.h).
+ *
+ *  Only the subset used by osc_api.h, biquad.hpp and the demo sources is provided.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __fast_inline
+#define __fast_inline static inline __attribute__((always_inline, optimize("Ofast")))
+#endif
+
+#define M_1_OVER_48K    (2.08333333333333e-005f)
+#define M_PI_F          (3.14159265358979323846f)
+#define M_TWOPI         (6.28318530717958647693f)
+
+__fast_inline float si_fabsf(float x) { return fabsf(x); }
+__fast_inline float si_floorf(float x) { return (float)((int32_t)x - (x < (float)(int32_t)x)); }
+__fast_inline float si_roundf(float x) { return si_floorf(x + 0.5f); }
+
+__fast_inline float clipmaxf(const float x, const float m) { return (((x) >= m) ? m : (x)); }
+__fast_inline float clipminf(const float m, const float x) { return (((x) <= m) ? m : (x)); }
+__fast_inline float clipminmaxf(const float min, const float x, const float max) { return (((x) >= max) ? max : ((x) <= min) ? min : (x)); }
+__fast_inline float clip0f(const float x) { return (((x) < 0.f) ? 0.f : (x)); }
+__fast_inline float clip1f(const float x) { return (((x) > 1.f) ? 1.f : (x)); }
+__fast_inline float clip01f(const float x) { return (((x) > 1.f) ? 1.f : ((x) < 0.f) ? 0.f : (x)); }
+__fast_inline float clip1m1f(const float x) { return (((x) > 1.f) ? 1.f : ((x) < -1.f) ? -1.f : (x)); }
+
+/** Linear interpolation: (1 - fr) * x0 + fr * x1, evaluated as in the SDK.
+ */
+__fast_inline float linintf(const float fr, const float x0, const float x1) { return x0 + fr * (x1 - x0); }
+
+#ifdef __cplusplus
+}
+#endif
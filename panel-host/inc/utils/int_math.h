@@ -0,0 +1,24 @@
+/** Host stand-in for the Logue SDK integer utility functions (utils/int_math.h).
+ *
+ *  Only the subset used by osc_api.h and the demo sources is provided.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __fast_inline static inline __attribute__((always_inline, optimize("Ofast")))
+
+__fast_inline uint32_t clipmaxu32(const uint32_t x, const uint32_t m) { return (((x) >= m) ? m : (x)); }
+__fast_inline uint32_t clipminu32(const uint32_t m, const uint32_t x) { return (((x) <= m) ? m : (x)); }
+__fast_inline uint32_t clipminmaxu32(const uint32_t min, const uint32_t x, const uint32_t max) { return (((x) >= max) ? max : ((x) <= min) ? min : (x)); }
+__fast_inline int32_t clipmaxi32(const int32_t x, const int32_t m) { return (((x) >= m) ? m : (x)); }
+__fast_inline int32_t clipmini32(const int32_t m, const int32_t x) { return (((x) <= m) ? m : (x)); }
+__fast_inline int32_t clipminmaxi32(const int32_t min, const int32_t x, const int32_t max) { return (((x) >= max) ? max : ((x) <= min) ? min : (x)); }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+/** Host stand-in for the out-of-line Logue SDK oscillator API functions.
+ *
+ *  The lookup tables themselves are generated at build time by osc_tables_gen.cpp.
+ */
+
+#include <math.h>
+#include "userosc.h"
+
+namespace
+{
+    /** Map a note to a fractional band-limit table index using the per-table note limits.
+     *
+     *  Notes at or below the first limit use table 0. Between two limits the index crossfades linearly
+     *  to the next table. The result is clamped just below the last table, so that osc_bl2_*f() can
+     *  always read table (idx + 1).
+     */
+    inline float bandLimitIndex(float note, const uint8_t* notes, unsigned count)
+    {
+        if (note <= float(notes[0])) return 0.0f;
+        for (unsigned i = 1; i != count; ++i)
+        {
+            if (note < float(notes[i]))
+            {
+                return float(i - 1) + (note - float(notes[i - 1])) / float(notes[i] - notes[i - 1]);
+            }
+        }
+        return nextafterf(float(count - 1), 0.0f);
+    }
+
+    uint32_t s_randState = 0x2545f491u;    // xorshift32 state (non-zero)
+}
+
+
+extern "C"
+{
+    const uint32_t k_osc_api_version = k_user_api_1_1_0;
+    const uint32_t k_osc_api_platform = k_user_target_host;
+
+    float _osc_bl_saw_idx(float note) { return bandLimitIndex(note, wt_saw_notes, k_wt_saw_notes_cnt); }
+    float _osc_bl_sqr_idx(float note) { return bandLimitIndex(note, wt_sqr_notes, k_wt_sqr_notes_cnt); }
+    float _osc_bl_par_idx(float note) { return bandLimitIndex(note, wt_par_notes, k_wt_par_notes_cnt); }
+
+    uint32_t _osc_mcu_hash(void)
+    {
+        return 0;
+    }
+
+    uint32_t _osc_rand(void)
+    {
+        s_randState ^= s_randState << 13;
+        s_randState ^= s_randState >> 17;
+        s_randState ^= s_randState << 5;
+        return s_randState;
+    }
+
+    float _osc_white(void)
+    {
+        return float(int32_t(_osc_rand())) * (1.0f / float(1u << 31));
+    }
+}
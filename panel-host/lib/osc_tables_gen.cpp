@@ -0,0 +1,118 @@
+/** Generator for the host stand-in of the Logue SDK firmware lookup tables.
+ *
+ *  The firmware tables referenced by osc_api.h are data in the synth's flash. This program rebuilds
+ *  them from their defining equations and writes them as C source, so the host library carries the
+ *  same table sizes, layouts and interpolation behaviour as the firmware:
+ *
+ *      midi_to_hz_lut_f        Equal temperament, A4 (note 69) = 440 Hz.
+ *      wt_sine_lut_f           Half period of sin(), 128 intervals plus the end point.
+ *      wt_{saw,sqr,par}_lut_f  Half period of a band-limited saw, square and parabola, 64 intervals plus
+ *                              the end point, one table per band-limit step. Table i contains all the
+ *                              harmonics that remain below Nyquist up to note wt_*_notes[i]. Lanczos
+ *                              sigma factors are applied to tame the Gibbs ripple between table points.
+ *
+ *  Usage: osc_tables_gen > osc_tables.c
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+namespace
+{
+    const double kPi = 3.14159265358979323846;
+    const double kSampleRate = 48000.0;
+    const unsigned kWaveSize = 64;                  // k_wt_*_size
+    const unsigned kWaveNotes = 7;                  // k_wt_*_notes_cnt
+
+    // Harmonic limit for each band-limit step. The first table is limited only by the table resolution.
+    const unsigned kHarmonics[kWaveNotes] = { 63, 32, 16, 8, 4, 2, 1 };
+
+    double noteHz(double note)
+    {
+        return 440.0 * std::pow(2.0, (note - 69.0) / 12.0);
+    }
+
+    unsigned highestNote(unsigned harmonics)
+    {
+        // Highest integral note whose top harmonic stays at or below Nyquist.
+        double note = 69.0 + 12.0 * std::log2((0.5 * kSampleRate) / (440.0 * double(harmonics)));
+        return unsigned(std::floor(note));
+    }
+
+    double sigma(unsigned k, unsigned harmonics)
+    {
+        // Lanczos sigma factor: sinc(k / (harmonics + 1))
+        double x = kPi * double(k) / double(harmonics + 1);
+        return std::sin(x) / x;
+    }
+
+    double saw(double phase, unsigned harmonics)
+    {
+        // Falling saw, +1 at phase 0+ to -1 at phase 1-: (2/pi) sum sin(2 pi k p) / k
+        double sum = 0.0;
+        for (unsigned k = 1; k <= harmonics; ++k) sum += sigma(k, harmonics) * std::sin(2.0 * kPi * k * phase) / k;
+        return sum * (2.0 / kPi);
+    }
+
+    double sqr(double phase, unsigned harmonics)
+    {
+        // Square, +1 for the first half period: (4/pi) sum_odd sin(2 pi k p) / k
+        double sum = 0.0;
+        for (unsigned k = 1; k <= harmonics; k += 2) sum += sigma(k, harmonics) * std::sin(2.0 * kPi * k * phase) / k;
+        return sum * (4.0 / kPi);
+    }
+
+    double par(double phase, unsigned harmonics)
+    {
+        // Parabola, 8p(1 - 2p) for the first half period: (32/pi^3) sum_odd sin(2 pi k p) / k^3
+        double sum = 0.0;
+        for (unsigned k = 1; k <= harmonics; k += 2) sum += sigma(k, harmonics) * std::sin(2.0 * kPi * k * phase) / (double(k) * k * k);
+        return sum * (32.0 / (kPi * kPi * kPi));
+    }
+
+    void emitWave(const char* name, double (*wave)(double, unsigned))
+    {
+        std::printf("const uint8_t wt_%s_notes[%u] = {", name, kWaveNotes);
+        for (unsigned i = 0; i != kWaveNotes; ++i) std::printf("%s %u", i ? "," : "", highestNote(kHarmonics[i]));
+        std::printf(" };\n\n");
+
+        std::printf("const float wt_%s_lut_f[%u] = {\n", name, kWaveNotes * (kWaveSize + 1));
+        for (unsigned t = 0; t != kWaveNotes; ++t)
+        {
+            for (unsigned i = 0; i <= kWaveSize; ++i)
+            {
+                double phase = 0.5 * double(i) / double(kWaveSize);
+                std::printf("%s%.9ef,%s", (i % 8) ? " " : "    ", float(wave(phase, kHarmonics[t])), ((i % 8) == 7 || i == kWaveSize) ? "\n" : "");
+            }
+        }
+        std::printf("};\n\n");
+    }
+}
+
+
+int main()
+{
+    std::printf("/* Generated by osc_tables_gen. Do not edit. */\n\n");
+    std::printf("#include <stdint.h>\n\n");
+
+    std::printf("const float midi_to_hz_lut_f[152] = {\n");
+    for (unsigned i = 0; i != 152; ++i)
+    {
+        std::printf("%s%.9ef,%s", (i % 8) ? " " : "    ", float(noteHz(double(i))), ((i % 8) == 7 || i == 151) ? "\n" : "");
+    }
+    std::printf("};\n\n");
+
+    std::printf("const float wt_sine_lut_f[129] = {\n");
+    for (unsigned i = 0; i <= 128; ++i)
+    {
+        std::printf("%s%.9ef,%s", (i % 8) ? " " : "    ", float(std::sin(kPi * double(i) / 128.0)), ((i % 8) == 7 || i == 128) ? "\n" : "");
+    }
+    std::printf("};\n\n");
+
+    emitWave("saw", &saw);
+    emitWave("sqr", &sqr);
+    emitWave("par", &par);
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+# #############################################################################
+# Project Customization
+# #############################################################################
+
+# This file is included from the host makefile. Put host specific Makefile customisations
+# here. Put the platform independent customisations in $(SRCDIR)/project.mk
+
+HOST_ARCH := $(shell uname -m)
+
+ifeq ($(HOST_ARCH),x86_64)
+    PLATFORM_UDEFS = -DDSP_INTEL_X64 -DDSP_CSTDLIB -DPLATFORM_HOST
+else ifeq ($(HOST_ARCH),aarch64)
+    PLATFORM_UDEFS = -DDSP_ARM_AARCH64 -DDSP_CSTDLIB -DPLATFORM_HOST
+else ifeq ($(HOST_ARCH),arm64)
+    PLATFORM_UDEFS = -DDSP_ARM_AARCH64 -DDSP_CSTDLIB -DPLATFORM_HOST
+else
+    PLATFORM_UDEFS = -DDSP_CSTDLIB -DPLATFORM_HOST
+endif
+
+# Include the project specific definitions.
+include ../src/project.mk
@@ -0,0 +1,88 @@
+/** Streaming audio file output for the host tools.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace host
+{
+    const uint32_t kOutputSampleRate = 48000;
+
+
+    /** Streaming Q31 output file: mono 32 bit PCM WAV at 48 kHz, or raw native-endian int32.
+     *
+     *  Samples are written as they are produced. For WAV output, the header is written with streaming
+     *  (maximum) sizes and patched on close if the output is seekable.
+     */
+    class AudioFileWriter
+    {
+    public:
+
+        ~AudioFileWriter() { close(); }
+
+        bool open(const char* path, bool wav)
+        {
+            m_wav = wav;
+            m_frames = 0;
+            m_file = (0 == std::strcmp(path, "-")) ? stdout : std::fopen(path, "wb");
+            if (!m_file) return false;
+            return m_wav ? writeWavHeader(0xffffffffu) : true;
+        }
+
+        bool write(const int32_t* samples, uint32_t frames)
+        {
+            m_frames += frames;
+            return frames == std::fwrite(samples, sizeof (int32_t), frames, m_file);
+        }
+
+        bool close()
+        {
+            if (!m_file) return true;
+            bool ok = true;
+            if (m_wav && 0 == std::fseek(m_file, 0, SEEK_SET))
+            {
+                // Patch the sizes if the output is seekable. Otherwise leave the streaming sizes.
+                uint64_t bytes = m_frames * sizeof (int32_t);
+                ok = writeWavHeader(bytes > 0xffffffdbu ? 0xffffffffu : uint32_t(bytes));
+            }
+            if (m_file != stdout) ok = (0 == std::fclose(m_file)) && ok;
+            else ok = (0 == std::fflush(m_file)) && ok;
+            m_file = nullptr;
+            return ok;
+        }
+
+    private:
+
+        bool writeWavHeader(uint32_t dataBytes)
+        {
+            // RIFF/WAVE, mono 32 bit PCM. Q31 samples are written unchanged.
+            uint8_t header[44];
+            const uint32_t riffBytes = (dataBytes > 0xffffffffu - 36) ? 0xffffffffu : dataBytes + 36;
+            std::memcpy(header + 0, "RIFF", 4);
+            put32(header + 4, riffBytes);
+            std::memcpy(header + 8, "WAVEfmt ", 8);
+            put32(header + 16, 16);                         // fmt chunk size
+            put16(header + 20, 1);                          // PCM
+            put16(header + 22, 1);                          // channels
+            put32(header + 24, kOutputSampleRate);                // sample rate
+            put32(header + 28, kOutputSampleRate * 4);            // byte rate
+            put16(header + 32, 4);                          // block align
+            put16(header + 34, 32);                         // bits per sample
+            std::memcpy(header + 36, "data", 4);
+            put32(header + 40, dataBytes);
+            return sizeof header == std::fwrite(header, 1, sizeof header, m_file);
+        }
+
+        static void put16(uint8_t* p, uint32_t n) { p[0] = uint8_t(n); p[1] = uint8_t(n >> 8); }
+        static void put32(uint8_t* p, uint32_t n) { put16(p, n); put16(p + 2, n >> 16); }
+
+    private:
+
+        FILE*       m_file      { nullptr };
+        bool        m_wav       { false };
+        uint64_t    m_frames    { 0 };
+    };
+
+}   // namespace
@@ -0,0 +1,341 @@
+/** Multi-threaded batch renderer for the host build.
+ *
+ *  Renders a list of patch/pitch configurations in parallel, with one demo::Engine per worker
+ *  thread. Each configuration starts from a freshly initialised engine, so the output of a
+ *  configuration does not depend on the thread or the order in which it is rendered. A summary line
+ *  (peak, RMS and a 64 bit FNV-1a hash of the Q31 samples) is printed for every configuration in
+ *  input order, which makes the output directly comparable between runs. Optionally, every
+ *  configuration is also written to a WAV file.
+ *
+ *  Usage: batch [options] [config-file]
+ *
+ *      -j, --jobs <n>              Number of worker threads (default: all cores).
+ *      -s, --seconds <n>           Render length per configuration, in seconds (default 1).
+ *      -o, --output-dir <dir>      Write each configuration to <dir>/<name>.wav.
+ *      -n, --notes <range>         Note grid as lo-hi/step (default 24-96/12).
+ *      -a, --shapes <range>        Shape grid as lo-hi/step, [0, 1023] (default 0-1023/256).
+ *      -b, --shift-shapes <range>  Shift-shape grid as lo-hi/step, [0, 1023] (default 0-1023/512).
+ *      -q, --quiet                 Do not print the throughput report.
+ *
+ *  Without a config file, the configurations are the cartesian product of the three grids. A config
+ *  file lists one configuration per line as "<name> <note> <shape> <shift-shape> [seconds]"; blank
+ *  lines and lines starting with '#' are ignored. Notes may be fractional, eg 60.5.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "userosc.h"
+#include "demo_engine.h"
+#include "audio_file_writer.h"
+
+namespace
+{
+    const uint32_t kSampleRate = 48000;
+    const uint32_t kBlockFrames = 64;
+
+
+    struct Config
+    {
+        std::string     name;
+        uint16_t        pitch;          // Q7.8
+        uint16_t        shape;          // [0, 1023]
+        uint16_t        shiftShape;     // [0, 1023]
+        uint64_t        frames;
+    };
+
+    struct Result
+    {
+        bool            ok              { false };
+        int32_t         peak            { 0 };
+        double          rms             { 0.0 };
+        uint64_t        hash            { 0 };
+    };
+
+
+    /** Parse a grid range of the form "lo-hi/step", "lo-hi" (step 1) or "value".
+     */
+    bool parseRange(const char* text, double& lo, double& hi, double& step)
+    {
+        char* end;
+        lo = std::strtod(text, &end);
+        if (end == text) return false;
+        hi = lo;
+        step = 1.0;
+        if (*end == '-')
+        {
+            text = end + 1;
+            hi = std::strtod(text, &end);
+            if (end == text || hi < lo) return false;
+        }
+        if (*end == '/')
+        {
+            text = end + 1;
+            step = std::strtod(text, &end);
+            if (end == text || step <= 0.0) return false;
+        }
+        return *end == 0;
+    }
+
+
+    bool readConfigs(const char* path, uint64_t defaultFrames, std::vector<Config>& configs)
+    {
+        FILE* file = std::fopen(path, "r");
+        if (!file) return false;
+
+        bool ok = true;
+        unsigned lineNumber = 0;
+        char line[1024];
+        while (ok && std::fgets(line, sizeof line, file))
+        {
+            ++lineNumber;
+            char name[512];
+            double note, shape, shiftShape, seconds = 0.0;
+            const char* p = line;
+            while (*p == ' ' || *p == '\t') ++p;
+            if (*p == '#' || *p == '\n' || *p == '\r' || *p == 0) continue;
+
+            int fields = std::sscanf(p, "%511s %lf %lf %lf %lf", name, &note, &shape, &shiftShape, &seconds);
+            ok = (fields >= 4) && note >= 0.0 && note < 128.0 && shape >= 0.0 && shape <= 1023.0
+                && shiftShape >= 0.0 && shiftShape <= 1023.0 && seconds >= 0.0;
+            if (!ok)
+            {
+                std::fprintf(stderr, "batch: %s:%u: invalid configuration\n", path, lineNumber);
+                break;
+            }
+
+            Config config;
+            config.name = name;
+            config.pitch = uint16_t(note * 256.0 + 0.5);
+            config.shape = uint16_t(shape + 0.5);
+            config.shiftShape = uint16_t(shiftShape + 0.5);
+            config.frames = (fields == 5) ? uint64_t(seconds * kSampleRate + 0.5) : defaultFrames;
+            configs.push_back(config);
+        }
+
+        std::fclose(file);
+        return ok;
+    }
+
+
+    /** Render one configuration on a caller supplied engine.
+     */
+    Result render(demo::Engine& engine, const Config& config, const char* outputDir)
+    {
+        Result result;
+
+        host::AudioFileWriter writer;
+        if (outputDir)
+        {
+            std::string path = std::string(outputDir) + "/" + config.name + ".wav";
+            if (!writer.open(path.c_str(), true)) return result;
+        }
+
+        engine.init(k_user_target_host_osc, k_user_api_1_1_0);
+        engine.param(k_user_osc_param_shape, config.shape);
+        engine.param(k_user_osc_param_shiftshape, config.shiftShape);
+
+        user_osc_param_t params;
+        std::memset(&params, 0, sizeof params);
+        params.pitch = config.pitch;
+
+        int32_t block[kBlockFrames];
+        uint64_t hash = 0xcbf29ce484222325ull;          // FNV-1a 64 bit basis
+        double sumSquares = 0.0;
+        int32_t peak = 0;
+
+        for (uint64_t frame = 0; frame < config.frames; frame += kBlockFrames)
+        {
+            const uint32_t frames = uint32_t((config.frames - frame) < kBlockFrames ? (config.frames - frame) : kBlockFrames);
+            engine.cycle(&params, block, frames);
+
+            for (uint32_t i = 0; i != frames; ++i)
+            {
+                const int32_t sample = block[i];
+                const int32_t magnitude = (sample == INT32_MIN) ? INT32_MAX : (sample < 0 ? -sample : sample);
+                if (magnitude > peak) peak = magnitude;
+                const double x = double(sample) * (1.0 / 2147483648.0);
+                sumSquares += x * x;
+                uint32_t bits = uint32_t(sample);
+                for (unsigned b = 0; b != 4; ++b)
+                {
+                    hash ^= (bits & 0xffu);
+                    hash *= 0x100000001b3ull;               // FNV-1a 64 bit prime
+                    bits >>= 8;
+                }
+            }
+
+            if (outputDir && !writer.write(block, frames)) return result;
+        }
+
+        if (outputDir && !writer.close()) return result;
+
+        result.ok = true;
+        result.peak = peak;
+        result.rms = config.frames ? std::sqrt(sumSquares / double(config.frames)) : 0.0;
+        result.hash = hash;
+        return result;
+    }
+
+
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: batch [options] [config-file]\n"
+            "  -j, --jobs <n>              worker threads (default: all cores)\n"
+            "  -s, --seconds <n>           render length per configuration (default 1)\n"
+            "  -o, --output-dir <dir>      write each configuration to <dir>/<name>.wav\n"
+            "  -n, --notes <range>         note grid, lo-hi/step (default 24-96/12)\n"
+            "  -a, --shapes <range>        shape grid, lo-hi/step (default 0-1023/256)\n"
+            "  -b, --shift-shapes <range>  shift-shape grid, lo-hi/step (default 0-1023/512)\n"
+            "  -q, --quiet                 no throughput report\n"
+            "config file lines: <name> <note> <shape> <shift-shape> [seconds]\n");
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    unsigned jobs = std::thread::hardware_concurrency();
+    double seconds = 1.0;
+    const char* outputDir = nullptr;
+    double notes[3] = { 24.0, 96.0, 12.0 };
+    double shapes[3] = { 0.0, 1023.0, 256.0 };
+    double shiftShapes[3] = { 0.0, 1023.0, 512.0 };
+    bool quiet = false;
+
+    static const struct option options[] =
+    {
+        { "jobs",           required_argument,  nullptr,    'j' },
+        { "seconds",        required_argument,  nullptr,    's' },
+        { "output-dir",     required_argument,  nullptr,    'o' },
+        { "notes",          required_argument,  nullptr,    'n' },
+        { "shapes",         required_argument,  nullptr,    'a' },
+        { "shift-shapes",   required_argument,  nullptr,    'b' },
+        { "quiet",          no_argument,        nullptr,    'q' },
+        { nullptr,          0,                  nullptr,    0   }
+    };
+
+    int option;
+    while (-1 != (option = getopt_long(argc, argv, "j:s:o:n:a:b:q", options, nullptr)))
+    {
+        bool ok = true;
+        switch (option)
+        {
+            case 'j':   jobs = unsigned(std::atoi(optarg)); ok = jobs > 0;                                  break;
+            case 's':   seconds = std::atof(optarg); ok = seconds > 0.0;                                    break;
+            case 'o':   outputDir = optarg;                                                                 break;
+            case 'n':   ok = parseRange(optarg, notes[0], notes[1], notes[2]) && notes[1] < 128.0;         break;
+            case 'a':   ok = parseRange(optarg, shapes[0], shapes[1], shapes[2]) && shapes[1] <= 1023.0;    break;
+            case 'b':   ok = parseRange(optarg, shiftShapes[0], shiftShapes[1], shiftShapes[2]) && shiftShapes[1] <= 1023.0; break;
+            case 'q':   quiet = true;                                                                       break;
+            default:    ok = false;                                                                         break;
+        }
+        if (!ok)
+        {
+            if (optarg) std::fprintf(stderr, "batch: invalid argument '%s'\n", optarg);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind + 1 < argc)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+    if (jobs == 0) jobs = 1;
+
+    const uint64_t defaultFrames = uint64_t(seconds * kSampleRate + 0.5);
+    std::vector<Config> configs;
+    if (optind < argc)
+    {
+        if (!readConfigs(argv[optind], defaultFrames, configs)) return EXIT_FAILURE;
+    }
+    else
+    {
+        for (double note = notes[0]; note <= notes[1]; note += notes[2])
+        {
+            for (double shape = shapes[0]; shape <= shapes[1]; shape += shapes[2])
+            {
+                for (double shiftShape = shiftShapes[0]; shiftShape <= shiftShapes[1]; shiftShape += shiftShapes[2])
+                {
+                    Config config;
+                    config.pitch = uint16_t(note * 256.0 + 0.5);
+                    config.shape = uint16_t(shape + 0.5);
+                    config.shiftShape = uint16_t(shiftShape + 0.5);
+                    config.frames = defaultFrames;
+                    char name[64];
+                    std::snprintf(name, sizeof name, "n%05.1f_s%04u_ss%04u", note, config.shape, config.shiftShape);
+                    config.name = name;
+                    configs.push_back(config);
+                }
+            }
+        }
+    }
+
+    if (jobs > configs.size() && !configs.empty()) jobs = unsigned(configs.size());
+
+    typedef std::chrono::steady_clock Clock;
+    const auto start = Clock::now();
+
+    // Workers claim configurations from a shared counter. Each worker owns one engine.
+    std::vector<Result> results(configs.size());
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned j = 0; j != jobs; ++j)
+    {
+        workers.push_back(std::thread([&configs, &results, &next, outputDir] {
+            demo::Engine engine;
+            for (size_t index; (index = next.fetch_add(1)) < configs.size(); )
+            {
+                results[index] = render(engine, configs[index], outputDir);
+            }
+        }));
+    }
+    for (auto& worker : workers) worker.join();
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    unsigned failures = 0;
+    uint64_t totalFrames = 0;
+    std::printf("name,pitch,shape,shift_shape,frames,peak,rms,hash\n");
+    for (size_t i = 0; i != configs.size(); ++i)
+    {
+        const Config& config = configs[i];
+        const Result& result = results[i];
+        totalFrames += config.frames;
+        if (!result.ok)
+        {
+            std::fprintf(stderr, "batch: %s: render failed\n", config.name.c_str());
+            ++failures;
+            continue;
+        }
+        std::printf("%s,0x%04x,%u,%u,%llu,%.6f,%.6f,%016llx\n",
+            config.name.c_str(), config.pitch, config.shape, config.shiftShape,
+            (unsigned long long)config.frames, double(result.peak) * (1.0 / 2147483648.0), result.rms,
+            (unsigned long long)result.hash);
+    }
+
+    if (!quiet)
+    {
+        const double audioSeconds = double(totalFrames) / kSampleRate;
+        std::fprintf(stderr, "configurations:  %zu on %u threads\n", configs.size(), jobs);
+        std::fprintf(stderr, "rendered:        %llu samples (%.3f s of audio)\n", (unsigned long long)totalFrames, audioSeconds);
+        std::fprintf(stderr, "wall time:       %.6f s\n", elapsed);
+        if (elapsed > 0.0)
+        {
+            std::fprintf(stderr, "throughput:      %.0f samples/sec\n", double(totalFrames) / elapsed);
+            std::fprintf(stderr, "real-time:       %.1fx (48 kHz)\n", audioSeconds / elapsed);
+        }
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
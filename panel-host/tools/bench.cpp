@@ -0,0 +1,1265 @@
+/** Microbenchmark suite for the host build.
+ *
+ *  Measures the cost per sample of the numeric conversions in logue_dsp.h, the sine kernels in
+ *  logue_sine.h, the demo oscillator and unison bank, the phase accumulator modes, the oscillator at
+ *  each oversampling factor and filter grade (logue_oversampling.h), the polyBLEP waveforms in
+ *  logue_blep.h against the SDK wave tables, the ADAA waveshaper curves in
+ *  logue_shaper.h against plain evaluation, the pitch table in logue_pitch.h,
+ *  the two oscillator mix, the LFO waveforms in logue_lfo.h and a complete OSC_CYCLE, with static
+ *  controls and with the panel emulator (panel_emulator.h) moving them, and the engine for each
+ *  platform policy (Prologue, Minilogue XD and NTS-1) side by side. The
+ *  conversions are covered for every fractional bit count from 0 to 31. Each benchmark is timed
+ *  over repeated runs and the fastest run is reported, which is the most stable figure on a
+ *  shared machine.
+ *
+ *  Host timings are converted to an estimated Cortex-M4 cycle count by a single scale factor (the
+ *  number of CM4 cycles that are assumed equivalent to one host nanosecond). The default of 12
+ *  models a ~4 GHz host that retires ~3 instructions per clock against the single-issue M4. This
+ *  is an estimate for comparing changes, not a substitute for on-target measurement: use
+ *  --cm4-scale to apply a figure calibrated against a real unit.
+ *
+ *  Usage: bench [options]
+ *
+ *      -f, --filter <text>         Only run benchmarks whose name contains <text>.
+ *      -o, --output <file>         Write the results as JSON to <file> ("-" for stdout).
+ *      -b, --baseline <file>       Compare the results against a JSON file written by --output.
+ *      -r, --max-regression <pct>  With --baseline, exit with status 1 if any benchmark is slower
+ *                                  than its baseline by more than <pct> percent.
+ *      -t, --min-time <ms>         Minimum duration of each timed run (default 2).
+ *      -c, --cm4-scale <n>         CM4 cycles per host nanosecond (default 12).
+ *      -l, --list                  List the benchmark names and exit.
+ *      -k, --check                 Run the self-checks instead of the benchmarks, and exit with status 1
+ *                                  if any fails.
+ */
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <getopt.h>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "userosc.h"
+#include "logue_blep.h"
+#include "logue_dsp.h"
+#include "logue_lfo.h"
+#include "logue_pitch.h"
+#include "logue_shaper.h"
+#include "demo_oscillator.h"
+#include "demo_oscillator_bank.h"
+#include "demo_engine.h"
+#include "panel_emulator.h"
+
+namespace
+{
+    const unsigned kBatch = 256;                // Samples per call for the scalar function benchmarks.
+    const unsigned kBlockFrames = 64;           // OSC_CYCLE block size.
+    const unsigned kRepeats = 5;                // Timed runs per benchmark; the fastest is reported.
+
+
+    /** Prevent the compiler from discarding a computed result.
+     */
+    template <typename T> inline void keep(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+
+    /** A single benchmark. @e setup prepares the inputs and is not timed. @e run executes the
+     *  workload once, processing @e samples samples.
+     */
+    struct Benchmark
+    {
+        std::string             name;
+        unsigned                samples;
+        std::function<void()>   setup;
+        std::function<void()>   run;
+    };
+
+    struct Result
+    {
+        std::string             name;
+        double                  nsPerSample;
+        double                  cm4CyclesPerSample;
+    };
+
+    typedef std::vector<Benchmark> Registry;
+
+
+    // Shared input and output buffers for the scalar function benchmarks.
+    float       g_floatIn[kBatch];
+    int32_t     g_s32In[kBatch];
+    uint32_t    g_u32In[kBatch];
+    float       g_floatOut[kBatch];
+    int32_t     g_s32Out[kBatch];
+    uint32_t    g_u32Out[kBatch];
+
+
+    void fillInputs(float scale, bool isSigned)
+    {
+        uint32_t state = 0x12345678u;
+        for (unsigned i = 0; i != kBatch; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            float unit = float(int32_t(state)) * (1.0f / 2147483648.0f);     // [-1, 1)
+            if (!isSigned) unit = 0.5f * (unit + 1.0f);                      // [0, 1)
+            g_floatIn[i] = unit * scale;
+            g_s32In[i] = int32_t(state);
+            g_u32In[i] = state;
+        }
+    }
+
+
+    /** The oscillator waveforms, by name and demo::BasicOscillator waveform index.
+     */
+    struct Waveform
+    {
+        const char*     name;
+        unsigned        index;
+    };
+
+    const Waveform kWaveforms[] =
+    {
+        { "Square",     demo::Oscillator::Square },
+        { "Parabola",   demo::Oscillator::Parabola },
+        { "Sawtooth",   demo::Oscillator::Sawtooth },
+    };
+
+
+    /** Register a benchmark that renders one block of an oscillator: demo::BasicOscillator, or any
+     *  class with the same setWaveform(), setPitch(), setModulation() and render().
+     *
+     *  @param  name        The benchmark name.
+     *  @param  index       The waveform index.
+     *  @param  note        The MIDI note.
+     *  @param  modulation  The phase modulation, [0, 1.0].
+     *  @param  voices      The voices rendered per sample, eg for a unison bank.
+     *  @return             The oscillator, for any further setup.
+     */
+    template <typename Osc> std::shared_ptr<Osc> addRenderBenchmark(Registry& registry, const std::string& name, unsigned index, int32_t note, float modulation, unsigned voices = 1)
+    {
+        auto oscillator = std::make_shared<Osc>();
+        oscillator->setWaveform(index);
+        oscillator->setPitch(note << 8);
+        oscillator->setModulation(modulation);
+        registry.push_back({ name, voices * kBlockFrames, [] {}, [oscillator] {
+            oscillator->render(g_floatOut, kBlockFrames);
+            keep(g_floatOut);
+        }});
+        return oscillator;
+    }
+
+
+    /** Register the conversion benchmarks for all fractional bit counts in [0, fbits].
+     *
+     *  The float to integer conversions use inputs that span 99% of the output range; the saturating
+     *  variants use inputs that exceed the range by 50% so that both clipping paths are exercised.
+     */
+    template <int fbits> struct ConversionBenchmarks
+    {
+        static const unsigned kBits = unsigned(fbits);
+
+        static void add(Registry& registry)
+        {
+            ConversionBenchmarks<fbits - 1>::add(registry);
+
+            const std::string suffix = "<" + std::to_string(kBits) + ">";
+            const float s32Range = float(1ull << (31 - kBits));
+            const float u32Range = float(1ull << (32 - kBits));
+
+            registry.push_back({ "logue::s32ToFloat" + suffix, kBatch, [] { fillInputs(1.0f, true); }, [] {
+                for (unsigned i = 0; i != kBatch; ++i) g_floatOut[i] = logue::s32ToFloat<kBits>(g_s32In[i]);
+                keep(g_floatOut);
+            }});
+            registry.push_back({ "logue::u32ToFloat" + suffix, kBatch, [] { fillInputs(1.0f, true); }, [] {
+                for (unsigned i = 0; i != kBatch; ++i) g_floatOut[i] = logue::u32ToFloat<kBits>(g_u32In[i]);
+                keep(g_floatOut);
+            }});
+            registry.push_back({ "logue::floatToS32" + suffix, kBatch, [s32Range] { fillInputs(0.99f * s32Range, true); }, [] {
+                for (unsigned i = 0; i != kBatch; ++i) g_s32Out[i] = logue::floatToS32<kBits>(g_floatIn[i]);
+                keep(g_s32Out);
+            }});
+            registry.push_back({ "logue::floatToU32" + suffix, kBatch, [u32Range] { fillInputs(0.99f * u32Range, false); }, [] {
+                for (unsigned i = 0; i != kBatch; ++i) g_u32Out[i] = logue::floatToU32<kBits>(g_floatIn[i]);
+                keep(g_u32Out);
+            }});
+            registry.push_back({ "logue::floatToS32_saturating" + suffix, kBatch, [s32Range] { fillInputs(1.5f * s32Range, true); }, [] {
+                for (unsigned i = 0; i != kBatch; ++i) g_s32Out[i] = logue::floatToS32_saturating<kBits>(g_floatIn[i]);
+                keep(g_s32Out);
+            }});
+            registry.push_back({ "logue::floatToU32_saturating" + suffix, kBatch, [u32Range] { fillInputs(1.5f * u32Range, true); }, [] {
+                for (unsigned i = 0; i != kBatch; ++i) g_u32Out[i] = logue::floatToU32_saturating<kBits>(g_floatIn[i]);
+                keep(g_u32Out);
+            }});
+        }
+    };
+
+    template <> struct ConversionBenchmarks<-1>
+    {
+        static void add(Registry&) {}
+    };
+
+
+    void addDspBenchmarks(Registry& registry)
+    {
+        ConversionBenchmarks<31>::add(registry);
+
+        // The block conversions, at the Q31 audio output format.
+        registry.push_back({ "logue::s32ToFloat[block]<31>", kBatch, [] { fillInputs(1.0f, true); }, [] {
+            logue::s32ToFloat<31>(g_s32In, g_floatOut, kBatch);
+            keep(g_floatOut);
+        }});
+        registry.push_back({ "logue::floatToS32_saturating[block]<31>", kBatch, [] { fillInputs(1.5f, true); }, [] {
+            logue::floatToS32_saturating<31>(g_floatIn, g_s32Out, kBatch);
+            keep(g_s32Out);
+        }});
+        registry.push_back({ "logue::floatScaleByPow2[block]", kBatch, [] { fillInputs(1.0f, true); }, [] {
+            logue::floatScaleByPow2(g_floatIn, g_floatOut, kBatch, -3);
+            keep(g_floatOut);
+        }});
+
+        registry.push_back({ "logue::floatScaleByPow2", kBatch, [] { fillInputs(1.0f, true); }, [] {
+            for (unsigned i = 0; i != kBatch; ++i) g_floatOut[i] = logue::floatScaleByPow2(g_floatIn[i], int(i & 7) - 4);
+            keep(g_floatOut);
+        }});
+    }
+
+
+    void addOscillatorBenchmarks(Registry& registry)
+    {
+        static const struct { const char* name; int32_t note; } notes[] =
+        {
+            { "low",        36 },
+            { "mid",        60 },
+            { "high",       96 },
+        };
+
+        for (const auto& waveform : kWaveforms)
+        {
+            for (const auto& note : notes)
+            {
+                addRenderBenchmark<demo::Oscillator>(registry, std::string("demo::Oscillator::render/") + waveform.name + "/" + note.name, waveform.index, note.note, 0.5f);
+            }
+        }
+    }
+
+
+    /** A 7 voice unison bank, against the same voices as separate oscillators rendered and summed,
+     *  with the same waves, sine and phase in both, and no oversampling.
+     */
+    template <typename Waves> void addUnisonBenchmark(Registry& registry, const char* wavesName)
+    {
+        typedef demo::BasicOscillatorBank<7, logue::SinePoly5, Waves> Bank;
+        typedef demo::BasicOscillator<demo::IntegerPhase, logue::SinePoly5, logue::Oversampler<1>, Waves> Voice;
+
+        for (const auto& waveform : kWaveforms)
+        {
+            auto bank = addRenderBenchmark<Bank>(registry, std::string("unison/OscillatorBank<7>/") + wavesName + "/" + waveform.name, waveform.index, 60, 0.5f, 7);
+            bank->reset(0x12345678u);
+            bank->setDetune(0.5f);
+
+            auto oscillators = std::make_shared<std::array<Voice, 7>>();
+            for (unsigned v = 0; v != oscillators->size(); ++v)
+            {
+                (*oscillators)[v].setWaveform(waveform.index);
+                (*oscillators)[v].setPitch((60 << 8) + int32_t(v * 16) - 48);
+                (*oscillators)[v].setModulation(0.5f);
+            }
+            registry.push_back({ std::string("unison/7x Oscillator/") + wavesName + "/" + waveform.name, 7 * kBlockFrames, [] {}, [oscillators] {
+                float voice[kBlockFrames];
+                (*oscillators)[0].render(g_floatOut, kBlockFrames);
+                for (unsigned v = 1; v != oscillators->size(); ++v)
+                {
+                    (*oscillators)[v].render(voice, kBlockFrames);
+                    for (unsigned i = 0; i != kBlockFrames; ++i) g_floatOut[i] += voice[i];
+                }
+                keep(g_floatOut);
+            }});
+        }
+    }
+
+    void addUnisonBenchmarks(Registry& registry)
+    {
+        addUnisonBenchmark<demo::WavesBlep>(registry, "Blep");
+        addUnisonBenchmark<demo::WavesSdk>(registry, "Sdk");
+    }
+
+
+    /** The oscillator with each sine kernel driving the phase modulation.
+     */
+    template <typename Sine> void addSineOscillatorBenchmark(Registry& registry, const char* sineName, const Waveform& waveform)
+    {
+        addRenderBenchmark<demo::BasicOscillator<demo::IntegerPhase, Sine>>(registry, std::string("sine/oscillator/") + sineName + "/" + waveform.name, waveform.index, 60, 0.5f);
+    }
+
+
+    /** The sine kernels in logue_sine.h, plus the SDK osc_sinf() for comparison.
+     */
+    template <typename Sine> void addSineBenchmark(Registry& registry, const char* name)
+    {
+        registry.push_back({ std::string("sine/") + name, kBatch, [] {
+            fillInputs(1.0f, false);
+            for (unsigned i = 0; i != kBatch; ++i) g_floatIn[i] = logue::u32ToFloat<24>(g_u32In[i] >> 8);   // [0, 1.0)
+        }, [] {
+            for (unsigned i = 0; i != kBatch; ++i) g_floatOut[i] = Sine::sine(g_floatIn[i]);
+            keep(g_floatOut);
+        }});
+    }
+
+    void addSineBenchmarks(Registry& registry)
+    {
+        addSineBenchmark<demo::SineSdk>(registry, "osc_sinf");
+        addSineBenchmark<logue::SineQuarterTable>(registry, "SineQuarterTable");
+        addSineBenchmark<logue::SinePoly5>(registry, "SinePoly5");
+        addSineBenchmark<logue::SineParabolic>(registry, "SineParabolic");
+
+        for (const auto& waveform : kWaveforms)
+        {
+            addSineOscillatorBenchmark<demo::SineSdk>(registry, "osc_sinf", waveform);
+            addSineOscillatorBenchmark<logue::SineQuarterTable>(registry, "SineQuarterTable", waveform);
+            addSineOscillatorBenchmark<logue::SinePoly5>(registry, "SinePoly5", waveform);
+            addSineOscillatorBenchmark<logue::SineParabolic>(registry, "SineParabolic", waveform);
+        }
+    }
+
+
+    /** Reference copy of the original Oscillator::render, which selects a waveform function pointer
+     *  once per block and calls it indirectly for every sample. Used to measure the saving from the
+     *  compile-time waveform dispatch in demo::BasicOscillator.
+     */
+    struct PointerDispatchOscillator
+    {
+        typedef float (*WaveFunction)(float phase, float bandwidthLimiter);
+
+        unsigned    waveformIndex   { 0 };
+        float       note            { 0.0f };
+        float       phase           { 0.0f };
+        float       phaseDelta      { 0.0f };
+        float       modulation      { 0.0f };
+
+        void setWaveform(unsigned index) { waveformIndex = index; }
+        void setModulation(float value) { modulation = value; }
+
+        void setPitch(int32_t pitch)
+        {
+            note = logue::s32ToFloat<8>(pitch);
+            phaseDelta = osc_w0f_for_note(uint8_t(unsigned(pitch >> 8) & 0xffu), uint8_t(unsigned(pitch) & 0xffu));
+        }
+
+        void render(float* yn, unsigned frames)
+        {
+            WaveFunction waveFunction;
+            float bandLimit;
+
+            switch (waveformIndex)
+            {
+                case 0:             waveFunction = &osc_bl2_sqrf;   bandLimit = osc_bl_sqr_idx(note);     break;
+                case 1:             waveFunction = &osc_bl2_parf;   bandLimit = osc_bl_par_idx(note);     break;
+                default:            waveFunction = &osc_bl2_sawf;   bandLimit = osc_bl_saw_idx(note);     break;
+            }
+
+            const auto mod = modulation * 0.75f;
+            auto p = phase;
+
+            for (unsigned i = 0; i != frames; ++i)
+            {
+                float modulatedPhase = p + (mod * osc_sinf(p));
+                if (modulatedPhase < 0.0f) modulatedPhase += 1.0f;
+                else if (modulatedPhase >= 1.0f) modulatedPhase -= 1.0f;
+
+                yn[i] = (waveFunction)(modulatedPhase, bandLimit);
+
+                p += phaseDelta;
+                if (p >= 1.0f) p -= 1.0f;
+            }
+
+            phase = p;
+        }
+    };
+
+
+    void addDispatchBenchmarks(Registry& registry)
+    {
+        for (const auto& waveform : kWaveforms)
+        {
+            addRenderBenchmark<PointerDispatchOscillator>(registry, std::string("dispatch/pointer/") + waveform.name, waveform.index, 60, 0.5f);
+
+            // The same float phase, osc_sinf() and SDK waves as the reference, so only the dispatch differs.
+            typedef demo::BasicOscillator<demo::FloatPhase, demo::SineSdk, logue::Oversampler<1>, demo::WavesSdk> Oscillator;
+            addRenderBenchmark<Oscillator>(registry, std::string("dispatch/template/") + waveform.name, waveform.index, 60, 0.5f);
+        }
+    }
+
+
+    /** The same oscillator with a float and with a UQ0.32 phase accumulator.
+     */
+    void addPhaseBenchmarks(Registry& registry)
+    {
+        for (const auto& waveform : kWaveforms)
+        {
+            addRenderBenchmark<demo::BasicOscillator<demo::FloatPhase>>(registry, std::string("phase/float/") + waveform.name, waveform.index, 60, 0.5f);
+            addRenderBenchmark<demo::BasicOscillator<demo::IntegerPhase>>(registry, std::string("phase/integer/") + waveform.name, waveform.index, 60, 0.5f);
+        }
+    }
+
+
+    /** The oscillator at each oversampling factor and decimation filter grade, whatever the build
+     *  options: a high note with full phase modulation, where oversampling is needed.
+     */
+    template <unsigned Factor, unsigned Quality> void addOversamplingBenchmark(Registry& registry, const char* name)
+    {
+        typedef demo::BasicOscillator<demo::IntegerPhase, logue::SinePoly5, logue::Oversampler<Factor, Quality>> Oscillator;
+        addRenderBenchmark<Oscillator>(registry, std::string("oversampling/") + name, demo::Oscillator::Sawtooth, 96, 1.0f);
+    }
+
+    void addOversamplingBenchmarks(Registry& registry)
+    {
+        addOversamplingBenchmark<1, 1>(registry, "1x");
+        addOversamplingBenchmark<2, 0>(registry, "2x/q0");
+        addOversamplingBenchmark<2, 1>(registry, "2x/q1");
+        addOversamplingBenchmark<2, 2>(registry, "2x/q2");
+        addOversamplingBenchmark<4, 0>(registry, "4x/q0");
+        addOversamplingBenchmark<4, 1>(registry, "4x/q1");
+        addOversamplingBenchmark<4, 2>(registry, "4x/q2");
+    }
+
+
+    /** The oscillator with the SDK wave tables and with the polyBLEP waves, at a middle note where the
+     *  residuals apply to a few samples per cycle and at a high note where they apply to most.
+     */
+    template <typename Waves> void addWaveOscillatorBenchmark(Registry& registry, const char* wavesName, const Waveform& waveform, int32_t note)
+    {
+        typedef demo::BasicOscillator<demo::IntegerPhase, logue::SinePoly5, logue::Oversampler<1>, Waves> Oscillator;
+        addRenderBenchmark<Oscillator>(registry, std::string("wave/oscillator/") + wavesName + "/" + waveform.name + "/" + std::to_string(note), waveform.index, note, 0.5f);
+    }
+
+
+    /** A waveform kernel over a batch of random phases at a fixed increment (note 84), so about one
+     *  sample in six is next to a discontinuity.
+     */
+    template <typename Wave> void addWaveKernelBenchmark(Registry& registry, const char* name)
+    {
+        registry.push_back({ std::string("wave/kernel/") + name, kBatch, [] {
+            fillInputs(1.0f, false);
+            for (unsigned i = 0; i != kBatch; ++i) g_floatIn[i] = logue::u32ToFloat<24>(g_u32In[i] >> 8);   // [0, 1.0)
+        }, [] {
+            const float increment = logue::u32ToFloat<32>(logue::PitchTable::phaseDelta(84 << 8));
+            const float bandLimit = Wave::bandLimit(84.0f);
+            for (unsigned i = 0; i != kBatch; ++i) g_floatOut[i] = Wave::sample(g_floatIn[i], increment, bandLimit);
+            keep(g_floatOut);
+        }});
+    }
+
+    void addWaveBenchmarks(Registry& registry)
+    {
+        for (const auto& waveform : kWaveforms)
+        {
+            for (int32_t note : { 60, 96 })
+            {
+                addWaveOscillatorBenchmark<demo::WavesSdk>(registry, "sdk", waveform, note);
+                addWaveOscillatorBenchmark<demo::WavesBlep>(registry, "blep", waveform, note);
+            }
+        }
+
+        addWaveKernelBenchmark<demo::WaveSquare>(registry, "osc_bl2_sqrf");
+        addWaveKernelBenchmark<demo::WaveParabola>(registry, "osc_bl2_parf");
+        addWaveKernelBenchmark<demo::WaveSawtooth>(registry, "osc_bl2_sawf");
+        addWaveKernelBenchmark<demo::WaveBlep<logue::BlepSquare>>(registry, "BlepSquare");
+        addWaveKernelBenchmark<demo::WaveBlep<logue::BlepParabola>>(registry, "BlepParabola");
+        addWaveKernelBenchmark<demo::WaveBlep<logue::BlepSawtooth>>(registry, "BlepSawtooth");
+        addWaveKernelBenchmark<demo::WaveBlep<logue::BlepTriangle>>(registry, "BlepTriangle");
+    }
+
+
+    /** A waveshaper curve applied to a block of the oscillator, with ADAA and evaluated directly (aliased).
+     */
+    template <typename Curve> void addShaperBenchmark(Registry& registry, const char* name, unsigned curveIndex)
+    {
+        auto input = std::make_shared<std::array<float, kBlockFrames>>();
+        demo::Oscillator oscillator;
+        oscillator.setWaveform(demo::Oscillator::Sawtooth);
+        oscillator.setPitch(84 << 8);
+        oscillator.render(input->data(), kBlockFrames);
+
+        auto shaper = std::make_shared<logue::AdaaShaper>();
+        shaper->setCurve(curveIndex);
+        shaper->setDrive(1.0f);
+        registry.push_back({ std::string("shaper/") + name + "/ADAA", kBlockFrames, [] {}, [input, shaper] {
+            std::memcpy(g_floatOut, input->data(), kBlockFrames * sizeof (float));
+            shaper->render(g_floatOut, kBlockFrames);
+            keep(g_floatOut);
+        }});
+
+        registry.push_back({ std::string("shaper/") + name + "/direct", kBlockFrames, [] {}, [input] {
+            for (unsigned i = 0; i != kBlockFrames; ++i) g_floatOut[i] = Curve::shape(Curve::kMaxGain * (*input)[i]);
+            keep(g_floatOut);
+        }});
+    }
+
+    void addShaperBenchmarks(Registry& registry)
+    {
+        addShaperBenchmark<logue::ShapeFold>(registry, "Fold", logue::AdaaShaper::Fold);
+        addShaperBenchmark<logue::ShapeSaturate>(registry, "Saturate", logue::AdaaShaper::Saturate);
+    }
+
+
+    /** Pitch to phase delta: the SDK osc_w0f_for_note() against the compile time logue::PitchTable.
+     */
+    void addPitchBenchmarks(Registry& registry)
+    {
+        auto fillPitches = [] { for (unsigned i = 0; i != kBatch; ++i) g_u32In[i] = (i * 0x9e3779b9u) >> 17; };
+
+        registry.push_back({ "pitch/osc_w0f_for_note", kBatch, fillPitches, [] {
+            for (unsigned i = 0; i != kBatch; ++i) g_floatOut[i] = osc_w0f_for_note(uint8_t(g_u32In[i] >> 8), uint8_t(g_u32In[i]));
+            keep(g_floatOut);
+        }});
+        registry.push_back({ "pitch/PitchTable", kBatch, fillPitches, [] {
+            for (unsigned i = 0; i != kBatch; ++i) g_u32Out[i] = logue::PitchTable::phaseDelta(g_u32In[i]);
+            keep(g_u32Out);
+        }});
+    }
+
+
+    /** The crossfade of the engine's buffered render, with a constant mix.
+     */
+    struct CrossfadeConstant
+    {
+        DSP_INLINE void tick(float& yn, float xn) { yn = 0.9f * (yn + mix * (xn - yn)); }
+        float mix;
+    };
+
+
+    /** Two oscillator render and mix: through two float scratch buffers (the original Engine::cycle),
+     *  through one buffer that VCO 2 is crossfaded into (the engine's default), or through the fused
+     *  demo::Oscillator::renderMix kernel (DEMO_FUSED_MIX), with a settled and with a ramping mix. All
+     *  convert to Q31 with floatToS32_saturating().
+     */
+    void addMixBenchmarks(Registry& registry)
+    {
+        static const struct { const char* name; unsigned index0; unsigned index1; } pairs[] =
+        {
+            { "Square+Sawtooth",    demo::Oscillator::Square,   demo::Oscillator::Sawtooth },
+            { "Parabola+Parabola",  demo::Oscillator::Parabola, demo::Oscillator::Parabola },
+        };
+
+        for (const auto& pair : pairs)
+        {
+            auto oscillators = std::make_shared<std::pair<demo::Oscillator, demo::Oscillator>>();
+            oscillators->first.setWaveform(pair.index0);
+            oscillators->first.setPitch(60 << 8);
+            oscillators->first.setModulation(0.5f);
+            oscillators->second.setWaveform(pair.index1);
+            oscillators->second.setPitch((60 << 8) + 7);
+            oscillators->second.setModulation(0.25f);
+
+            registry.push_back({ std::string("mix/buffered/") + pair.name, kBlockFrames, [] {}, [oscillators] {
+                float buffer[2][kBlockFrames];
+                oscillators->first.render(&buffer[0][0], kBlockFrames);
+                oscillators->second.render(&buffer[1][0], kBlockFrames);
+                for (unsigned i = 0; i != kBlockFrames; ++i)
+                {
+                    g_s32Out[i] = logue::floatToS32_saturating<31>((0.3f * buffer[0][i]) + (0.6f * buffer[1][i]));
+                }
+                keep(g_s32Out);
+            }});
+
+            registry.push_back({ std::string("mix/crossfade/") + pair.name, kBlockFrames, [] {}, [oscillators] {
+                float buffer[kBlockFrames];
+                CrossfadeConstant mixer { 2.0f / 3.0f };
+                oscillators->first.render(buffer, kBlockFrames);
+                oscillators->second.render(buffer, kBlockFrames, mixer);
+                logue::floatToS32_saturating<31>(buffer, g_s32Out, kBlockFrames);
+                keep(g_s32Out);
+            }});
+
+            registry.push_back({ std::string("mix/fused/") + pair.name, kBlockFrames, [] {}, [oscillators] {
+                logue::SmoothConstant mix(2.0f / 3.0f);
+                demo::Oscillator::renderMix(oscillators->first, oscillators->second, mix, 0.9f, g_s32Out, kBlockFrames);
+                keep(g_s32Out);
+            }});
+
+            registry.push_back({ std::string("mix/smoothed/") + pair.name, kBlockFrames, [] {}, [oscillators] {
+                logue::OnePoleSmoother mix(0.0016449037f, 0.0f);
+                mix.setTarget(1.0f, kBlockFrames);
+                demo::Oscillator::renderMix(oscillators->first, oscillators->second, mix, 0.9f, g_s32Out, kBlockFrames);
+                keep(g_s32Out);
+            }});
+        }
+    }
+
+
+    /** The logue::Lfo waveforms, rendering a block from an LfoReader.
+     */
+    void addLfoBenchmarks(Registry& registry)
+    {
+        static const struct { const char* name; unsigned waveform; } waveforms[] =
+        {
+            { "Square",         logue::Lfo::kSquare },
+            { "Triangle",       logue::Lfo::kTriangle },
+            { "Saw",            logue::Lfo::kSaw },
+            { "Sine",           logue::Lfo::kSine },
+            { "ExpDown",        logue::Lfo::kExpDown },
+            { "ExpUp",          logue::Lfo::kExpUp },
+            { "SampleHold",     logue::Lfo::kSampleHold },
+            { "SmoothRandom",   logue::Lfo::kSmoothRandom },
+        };
+
+        struct State
+        {
+            logue::Lfo              lfo;
+            logue::LfoReader        reader;
+            logue::PanelSnapshot    snapshot;
+        };
+
+        for (const auto& waveform : waveforms)
+        {
+            auto state = std::make_shared<State>();
+            state->lfo.setWaveform(waveform.waveform);
+            state->reader.setClock(40500.0f);
+            registry.push_back({ std::string("lfo/") + waveform.name, kBlockFrames, [state] {
+                // Each block starts from the same phase, a quarter cycle in, at ~0.2 cycles per block.
+                state->lfo.reset(0);
+                std::memset(&state->snapshot, 0, sizeof state->snapshot);
+                state->snapshot.lfoIsActive = true;
+                state->snapshot.lfoPhase = 0x40000000u;
+                state->snapshot.lfoPhaseDelta = 0x01000000u;
+            }, [state] {
+                state->reader.begin(state->snapshot);
+                state->lfo.render(state->reader, g_floatOut, kBlockFrames, 0.5f);
+                keep(g_floatOut);
+            }});
+        }
+    }
+
+
+    /** Control activity for OSC_CYCLE/panel: knob glides, waveform switches and a running LFO, all
+     *  faster than a player would manage, repeating every two seconds.
+     */
+    const char* const kPanelScript =
+        "0       lfo.wave        1\n"
+        "0       lfo.rate        8\n"
+        "0       vco1.shape      0\n"
+        "0       vco1.shape      1       1\n"
+        "1       vco1.shape      0       1\n"
+        "0       vco2.shape      0.5\n"
+        "0       vco2.pitch      7\n"
+        "0.5     vco2.pitch      7.1     1\n"
+        "0       vco1.wave       0\n"
+        "0.25    vco1.wave       1\n"
+        "0.5     vco1.wave       2\n"
+        "0.75    vco2.wave       0\n"
+        "1.25    vco2.wave       2\n"
+        "1.5     lfo.wave        2\n"
+        "1.75    lfo.wave        1\n";
+
+    const double kPanelScriptSeconds = 2.0;
+
+    std::unique_ptr<host::PanelEmulator> g_panel;      // Only while a panel benchmark runs
+
+
+    /** Attach the engine behind the SDK entry points to a new panel emulator, or return it to the
+     *  defaults and destroy the emulator if @e panel is null.
+     */
+    void usePanel(host::PanelEmulator* panel)
+    {
+        if (panel) demo::hostEngine().panel().attach(panel->memory());
+        else demo::hostEngine().panel().detach();
+        g_panel.reset(panel);
+    }
+
+
+    void addCycleBenchmarks(Registry& registry)
+    {
+        static user_osc_param_t params;
+        registry.push_back({ "OSC_CYCLE", kBlockFrames, [] {
+            usePanel(nullptr);
+            _entry(k_user_target_host_osc, k_user_api_1_1_0);
+            _hook_param(k_user_osc_param_shape, 512);
+            _hook_param(k_user_osc_param_shiftshape, 256);
+            std::memset(&params, 0, sizeof params);
+            params.pitch = 60 << 8;
+        }, [] {
+            _hook_cycle(&params, g_s32Out, kBlockFrames);
+            keep(g_s32Out);
+        }});
+
+        // A single frame block, which is dominated by the per-block control overhead.
+        registry.push_back({ "OSC_CYCLE/control", 1, [] {
+            usePanel(nullptr);
+            _entry(k_user_target_host_osc, k_user_api_1_1_0);
+            _hook_param(k_user_osc_param_shape, 512);
+            _hook_param(k_user_osc_param_shiftshape, 256);
+            std::memset(&params, 0, sizeof params);
+            params.pitch = 60 << 8;
+        }, [] {
+            _hook_cycle(&params, g_s32Out, 1);
+            keep(g_s32Out);
+        }});
+
+        // Full blocks in unison mode: two 7 voice banks.
+        registry.push_back({ "OSC_CYCLE/unison", kBlockFrames, [] {
+            usePanel(nullptr);
+            _entry(k_user_target_host_osc, k_user_api_1_1_0);
+            _hook_param(k_user_osc_param_id1, 50);
+            _hook_param(k_user_osc_param_shape, 512);
+            _hook_param(k_user_osc_param_shiftshape, 0);
+            std::memset(&params, 0, sizeof params);
+            params.pitch = 60 << 8;
+        }, [] {
+            _hook_cycle(&params, g_s32Out, kBlockFrames);
+            keep(g_s32Out);
+        }});
+
+        // Full blocks with both VCOs through the wavefolder.
+        registry.push_back({ "OSC_CYCLE/fold", kBlockFrames, [] {
+            usePanel(nullptr);
+            _entry(k_user_target_host_osc, k_user_api_1_1_0);
+            _hook_param(k_user_osc_param_id2, 1);
+            _hook_param(k_user_osc_param_shape, 512);
+            _hook_param(k_user_osc_param_shiftshape, 0);
+            std::memset(&params, 0, sizeof params);
+            params.pitch = 60 << 8;
+        }, [] {
+            _hook_cycle(&params, g_s32Out, kBlockFrames);
+            keep(g_s32Out);
+        }});
+
+        // Full blocks with the panel emulator moving the controls, so the panel-reactive paths run.
+        registry.push_back({ "OSC_CYCLE/panel", kBlockFrames, [] {
+            usePanel(new host::PanelEmulator);
+            std::string error;
+            if (!g_panel->parse(kPanelScript, error)) std::fprintf(stderr, "bench: panel script: %s\n", error.c_str());
+            _entry(k_user_target_host_osc, k_user_api_1_1_0);
+            _hook_param(k_user_osc_param_shape, 512);
+            _hook_param(k_user_osc_param_shiftshape, 256);
+            std::memset(&params, 0, sizeof params);
+            params.pitch = 60 << 8;
+        }, [] {
+            if (g_panel->time() >= kPanelScriptSeconds) g_panel->rewind();
+            g_panel->advance(kBlockFrames);
+            _hook_cycle(&params, g_s32Out, kBlockFrames);
+            keep(g_s32Out);
+        }});
+    }
+
+
+    /** The panel state for one platform's engine in addPlatformBenchmarks(), registered for that
+     *  platform's engine by attach(): a triangle LFO at 6 Hz, with the other controls neutral. NTS-1 has no panel.
+     */
+    template <typename Platform, bool = Platform::kPanelSupport> class PlatformPanel
+    {
+    public:
+
+        PlatformPanel()
+        {
+            m_main = Platform::mainStateDefaults();
+            std::memset(&m_lfo, 0, sizeof m_lfo);
+            std::memset(&m_envelope, 0, sizeof m_envelope);
+            std::memset(&m_vco, 0, sizeof m_vco);
+            m_lfo.waveform = 1;
+            m_lfo.phaseDelta = uint32_t(6.0 * 4294967296.0 / Platform::kLfoClockHz);
+            activate(m_lfo);
+
+            m_memory.main = &m_main;
+            m_memory.lfo = &m_lfo;
+            m_memory.envelope = &m_envelope;
+            m_memory.vco = &m_vco;
+        }
+
+        void attach(logue::BasicPanel<Platform>& panel) { panel.attach(m_memory); }
+
+        /** Run the LFO interrupt for one block.
+         */
+        void advance() { m_lfo.phaseValue += m_lfo.phaseDelta * uint32_t(kBlockFrames * Platform::kLfoClockHz / 48000.0f); }
+
+    private:
+
+        static void activate(logue::LfoState_Prologue_210&) {}
+        static void activate(logue::LfoState_Minilogue_210& lfo) { lfo.active = 1; }
+
+        typename Platform::MainState            m_main;
+        typename Platform::LfoState             m_lfo;
+        typename Platform::EnvelopeState        m_envelope;
+        typename Platform::VcoStateArray        m_vco;
+        logue::BasicHostPanelMemory<Platform>   m_memory;
+    };
+
+    template <typename Platform> class PlatformPanel<Platform, false>
+    {
+    public:
+        void attach(logue::BasicPanel<Platform, false>& panel) { (void)panel; }
+        void advance() {}
+    };
+
+
+    /** A complete OSC_CYCLE block through demo::BasicEngine for one platform, with the LFO modulating
+     *  the mix. The engine is used directly rather than through the SDK entry points, so that every
+     *  platform can run in the same binary.
+     */
+    template <typename Platform> void addPlatformBenchmark(Registry& registry)
+    {
+        struct State
+        {
+            PlatformPanel<Platform>         panel;
+            demo::BasicEngine<Platform>     engine;
+            user_osc_param_t                params;
+        };
+        auto state = std::make_shared<State>();
+
+        registry.push_back({ std::string("platform/") + Platform::name(), kBlockFrames, [state] {
+            state->panel.attach(state->engine.panel());
+            state->engine.init(0, 0);
+            state->engine.param(k_user_osc_param_shape, 512);
+            state->engine.param(k_user_osc_param_shiftshape, 256);
+            std::memset(&state->params, 0, sizeof state->params);
+            state->params.pitch = 60 << 8;
+        }, [state] {
+            state->panel.advance();
+            state->engine.cycle(&state->params, g_s32Out, kBlockFrames);
+            keep(g_s32Out);
+        }});
+    }
+
+
+    /** The engine for each platform, side by side.
+     */
+    void addPlatformBenchmarks(Registry& registry)
+    {
+        addPlatformBenchmark<logue::ProloguePlatform>(registry);
+        addPlatformBenchmark<logue::MinilogueXdPlatform>(registry);
+        addPlatformBenchmark<logue::Nts1Platform>(registry);
+    }
+
+
+
+    // ---------------------------------------------------------------------------------------------
+    // Self-checks (--check). These compare code paths that the timings assume are equivalent, and
+    // exercise code that only runs on the synth.
+
+    /** Report a failed check.
+     */
+    unsigned fail(const char* check, const char* detail)
+    {
+        std::fprintf(stderr, "check failed: %s: %s\n", check, detail);
+        return 1;
+    }
+
+
+    /** A platform with three releases over different ranges of flash, so that the checksum passes
+     *  more than one checkpoint. The checksums are arbitrary, as the images are made to match them.
+     */
+    constexpr logue::FirmwareLayout kCheckFirmwareLayouts[] =
+    {
+        //  flashHash       blocks  version     layout              main    lfo     envelope    vco
+        {   0x00000001u,    100,    0x0100,     logue::kLayout210,  0,      0,      0,          0   },
+        {   0x00000002u,    384,    0x0300,     logue::kLayout210,  0,      0,      0,          0   },
+        {   0x00000003u,    200,    0x0200,     logue::kLayout210,  0,      0,      0,          0   },
+    };
+
+    struct CheckPlatform : logue::MinilogueXdPlatform
+    {
+        static const unsigned kFirmwareLayoutCount = sizeof kCheckFirmwareLayouts / sizeof kCheckFirmwareLayouts[0];
+        static constexpr const logue::FirmwareLayout* firmwareLayouts() { return kCheckFirmwareLayouts; }
+        static const char* name() { return "ThreeReleases"; }
+    };
+
+
+    /** The panel's flash checksum, restated so that an image can be made to match a release.
+     */
+    uint32_t mixHash(uint32_t hash, uint32_t partial)
+    {
+        hash ^= partial;
+        hash ^= hash << 13;
+        hash ^= hash >> 17;
+        hash ^= hash << 5;
+        return hash;
+    }
+
+    uint32_t unmixHash(uint32_t hash)
+    {
+        // Each step x ^= x << k is undone by repeating it until the shifted bits run out.
+        uint32_t x = hash;
+        for (unsigned i = 0; i != 7; ++i) x = hash ^ (x << 5);
+        hash = x;
+        for (unsigned i = 0; i != 2; ++i) x = hash ^ (x >> 17);
+        hash = x;
+        for (unsigned i = 0; i != 3; ++i) x = hash ^ (x << 13);
+        return x;
+    }
+
+
+    /** Fill a flash image with noise, then set the last block of the range of @e release so that the
+     *  checksum at its end is the release's.
+     */
+    template <typename Platform> void makeFlashImage(std::vector<uint32_t>& image, const logue::FirmwareLayout* release)
+    {
+        image.resize(8 * logue::FirmwareRegistry<Platform>::hashBlocks());
+        uint32_t state = 0x2545f491u;
+        for (auto& word : image) word = state = mixHash(state, 0x9e3779b9u);
+        if (release == nullptr) return;
+
+        uint32_t hash = 0x1200;
+        for (unsigned block = 0; block + 1 < release->flashBlocks; ++block)
+        {
+            uint32_t partial = 0;
+            for (unsigned i = 0; i != 8; ++i) partial += image[8 * block + i];
+            hash = mixHash(hash, partial);
+        }
+        uint32_t* last = &image[8 * (release->flashBlocks - 1)];
+        uint32_t partial = unmixHash(release->flashHash) ^ hash;
+        for (unsigned i = 1; i != 8; ++i) partial -= last[i];
+        last[0] = partial;
+    }
+
+
+    /** The firmware identification of BasicPanel::validate(), run over images of the flash. Each
+     *  release must be found, however the checksum is split into validate() calls, and an image of
+     *  no release must complete unrecognised.
+     */
+    template <typename Platform> unsigned checkFirmwareHash()
+    {
+        typedef logue::FirmwareRegistry<Platform> Registry;
+        const std::string check = std::string("firmware hash/") + Platform::name();
+        unsigned failures = 0;
+
+        for (int index = -1; index != int(Platform::kFirmwareLayoutCount); ++index)
+        {
+            const logue::FirmwareLayout* release = (index < 0) ? nullptr : &Platform::firmwareLayouts()[index];
+            std::vector<uint32_t> image;
+            makeFlashImage<Platform>(image, release);
+
+            static const unsigned steps[] = { 1, 3, 16, Registry::hashBlocks() };
+            for (unsigned step : steps)
+            {
+                logue::BasicPanel<Platform> panel(logue::PanelValidation::Deferred);
+                panel.hashImage(image.data());
+                unsigned calls = 0;
+                while (panel.isValidating() && calls++ <= Registry::hashBlocks()) panel.validate(step);
+
+                char detail[96];
+                std::snprintf(detail, sizeof detail, "release %d, %u blocks per call", index, step);
+                if (panel.isValidating()) failures += fail(check.c_str(), (std::string(detail) + ": did not complete").c_str());
+                else if (panel.firmware() != release) failures += fail(check.c_str(), (std::string(detail) + ": wrong release").c_str());
+            }
+        }
+        return failures;
+    }
+
+
+    /** The block floatToS32_saturating() and s32ToFloat() of the build's instruction set against the
+     *  scalar versions, at the edges of the range: +-1.0, exactly 2^31 after scaling and just below,
+     *  negative overflow, infinity and NaN (which gives the target's conversion, but the same one on
+     *  both paths). Every length up to kLength is converted, so each value passes through the wide,
+     *  the narrow and the scalar tail of the block loops.
+     */
+    template <unsigned fbits> unsigned checkBlockConversions()
+    {
+        const std::string check = "block conversion<" + std::to_string(fbits) + ">";
+        const float limit = float(1ull << (31 - fbits));                    // 2^31 after scaling
+        const float floats[] =
+        {
+            0.0f, 1.0f, -1.0f, 0.5f, -0.75f,
+            limit, -limit, std::nextafter(limit, 0.0f), std::nextafter(-limit, 0.0f),
+            2.0f * limit, -2.0f * limit, 1.0e-10f,
+            std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+            std::numeric_limits<float>::quiet_NaN(),
+        };
+        const int32_t integers[] = { 0, 1, -1, INT32_MAX, INT32_MIN, 0x01000001, -0x01000001, 0x40000000, 12345678 };
+
+        static const unsigned kLength = 40;
+        float floatIn[kLength], floatOut[kLength];
+        int32_t s32In[kLength], s32Out[kLength];
+        for (unsigned i = 0; i != kLength; ++i)
+        {
+            floatIn[i] = floats[i % (sizeof floats / sizeof floats[0])];
+            s32In[i] = integers[i % (sizeof integers / sizeof integers[0])];
+        }
+
+        unsigned failures = 0;
+        char detail[96];
+        for (unsigned count = 1; count <= kLength; ++count)
+        {
+            logue::floatToS32_saturating<fbits>(floatIn, s32Out, count);
+            logue::s32ToFloat<fbits>(s32In, floatOut, count);
+            for (unsigned i = 0; i != count; ++i)
+            {
+                const int32_t expected = logue::floatToS32_saturating<fbits>(floatIn[i]);
+                if (s32Out[i] != expected)
+                {
+                    std::snprintf(detail, sizeof detail, "floatToS32_saturating(%g) is %d, not %d, at %u of %u", floatIn[i], s32Out[i], expected, i, count);
+                    failures += fail(check.c_str(), detail);
+                }
+                const float expectedFloat = logue::s32ToFloat<fbits>(s32In[i]);
+                if (0 != std::memcmp(&floatOut[i], &expectedFloat, sizeof expectedFloat))
+                {
+                    std::snprintf(detail, sizeof detail, "s32ToFloat(%d) is %g, not %g, at %u of %u", s32In[i], floatOut[i], expectedFloat, i, count);
+                    failures += fail(check.c_str(), detail);
+                }
+            }
+        }
+        return failures;
+    }
+
+
+    /** Run the self-checks, returning the number of failures.
+     */
+    unsigned runChecks()
+    {
+        unsigned failures = 0;
+        failures += checkBlockConversions<0>();
+        failures += checkBlockConversions<1>();
+        failures += checkBlockConversions<31>();
+        failures += checkFirmwareHash<logue::ProloguePlatform>();
+        failures += checkFirmwareHash<logue::MinilogueXdPlatform>();
+        failures += checkFirmwareHash<CheckPlatform>();
+        return failures;
+    }
+
+
+    /** Time a benchmark, returning the fastest time per sample in nanoseconds.
+     */
+    double measure(const Benchmark& benchmark, double minSeconds)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        benchmark.setup();
+
+        // Calibrate the iteration count so that each timed run lasts at least minSeconds.
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            const auto t0 = Clock::now();
+            for (uint64_t i = 0; i != iterations; ++i) benchmark.run();
+            const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (elapsed >= minSeconds) break;
+            iterations *= (elapsed > 0.0 && minSeconds / elapsed < 100.0) ? uint64_t(minSeconds / elapsed) + 1 : 100;
+        }
+
+        double best = 0.0;
+        for (unsigned r = 0; r != kRepeats; ++r)
+        {
+            const auto t0 = Clock::now();
+            for (uint64_t i = 0; i != iterations; ++i) benchmark.run();
+            const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (r == 0 || elapsed < best) best = elapsed;
+        }
+
+        return 1.0e9 * best / (double(iterations) * double(benchmark.samples));
+    }
+
+
+    /** Write results as JSON. One result per line, so that the file is easy to diff and to parse.
+     */
+    bool writeJson(const char* path, const std::vector<Result>& results, double cm4Scale)
+    {
+        FILE* file = (0 == std::strcmp(path, "-")) ? stdout : std::fopen(path, "w");
+        if (!file) return false;
+
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"suite\": \"panel-demo\",\n");
+        std::fprintf(file, "  \"cm4_scale\": %.3f,\n", cm4Scale);
+        std::fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i != results.size(); ++i)
+        {
+            std::fprintf(file, "    { \"name\": \"%s\", \"ns_per_sample\": %.4f, \"cm4_cycles_per_sample\": %.2f }%s\n",
+                results[i].name.c_str(), results[i].nsPerSample, results[i].cm4CyclesPerSample,
+                (i + 1 == results.size()) ? "" : ",");
+        }
+        std::fprintf(file, "  ]\n");
+        std::fprintf(file, "}\n");
+
+        bool ok = !std::ferror(file);
+        if (file != stdout) ok = (0 == std::fclose(file)) && ok;
+        return ok;
+    }
+
+
+    /** Read the per-benchmark ns/sample figures from a file written by writeJson().
+     */
+    bool readJson(const char* path, std::map<std::string, double>& results)
+    {
+        FILE* file = std::fopen(path, "r");
+        if (!file) return false;
+
+        char line[1024];
+        while (std::fgets(line, sizeof line, file))
+        {
+            char name[512];
+            double ns;
+            const char* p = std::strstr(line, "\"name\": \"");
+            if (p && 2 == std::sscanf(p, "\"name\": \"%511[^\"]\", \"ns_per_sample\": %lf", name, &ns))
+            {
+                results[name] = ns;
+            }
+        }
+
+        std::fclose(file);
+        return true;
+    }
+
+
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: bench [options]\n"
+            "  -f, --filter <text>         only run benchmarks whose name contains <text>\n"
+            "  -o, --output <file>         write results as JSON (\"-\" for stdout)\n"
+            "  -b, --baseline <file>       compare against a JSON file written by --output\n"
+            "  -r, --max-regression <pct>  with --baseline, fail if any result regresses by more than <pct>%%\n"
+            "  -t, --min-time <ms>         minimum duration of each timed run (default 2)\n"
+            "  -c, --cm4-scale <n>         CM4 cycles per host nanosecond (default 12)\n"
+            "  -l, --list                  list benchmark names and exit\n"
+            "  -k, --check                 run the self-checks and exit\n");
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    const char* outputPath = nullptr;
+    const char* baselinePath = nullptr;
+    double maxRegression = -1.0;
+    double minSeconds = 0.002;
+    double cm4Scale = 12.0;
+    bool list = false;
+    bool check = false;
+
+    static const struct option options[] =
+    {
+        { "filter",         required_argument,  nullptr,    'f' },
+        { "output",         required_argument,  nullptr,    'o' },
+        { "baseline",       required_argument,  nullptr,    'b' },
+        { "max-regression", required_argument,  nullptr,    'r' },
+        { "min-time",       required_argument,  nullptr,    't' },
+        { "cm4-scale",      required_argument,  nullptr,    'c' },
+        { "list",           no_argument,        nullptr,    'l' },
+        { "check",          no_argument,        nullptr,    'k' },
+        { nullptr,          0,                  nullptr,    0   }
+    };
+
+    int option;
+    while (-1 != (option = getopt_long(argc, argv, "f:o:b:r:t:c:lk", options, nullptr)))
+    {
+        bool ok = true;
+        switch (option)
+        {
+            case 'f':   filter = optarg;                                                    break;
+            case 'o':   outputPath = optarg;                                                break;
+            case 'b':   baselinePath = optarg;                                              break;
+            case 'r':   maxRegression = std::atof(optarg); ok = maxRegression >= 0.0;       break;
+            case 't':   minSeconds = 0.001 * std::atof(optarg); ok = minSeconds > 0.0;      break;
+            case 'c':   cm4Scale = std::atof(optarg); ok = cm4Scale > 0.0;                  break;
+            case 'l':   list = true;                                                        break;
+            case 'k':   check = true;                                                       break;
+            default:    ok = false;                                                         break;
+        }
+        if (!ok)
+        {
+            if (optarg) std::fprintf(stderr, "bench: invalid argument '%s'\n", optarg);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    if (check)
+    {
+        const unsigned failures = runChecks();
+        if (failures)
+        {
+            std::fprintf(stderr, "bench: %u check(s) failed\n", failures);
+            return 1;
+        }
+        std::fprintf(stderr, "bench: all checks passed\n");
+        return EXIT_SUCCESS;
+    }
+
+    Registry registry;
+    addDspBenchmarks(registry);
+    addOscillatorBenchmarks(registry);
+    addUnisonBenchmarks(registry);
+    addSineBenchmarks(registry);
+    addDispatchBenchmarks(registry);
+    addPhaseBenchmarks(registry);
+    addOversamplingBenchmarks(registry);
+    addWaveBenchmarks(registry);
+    addShaperBenchmarks(registry);
+    addPitchBenchmarks(registry);
+    addMixBenchmarks(registry);
+    addLfoBenchmarks(registry);
+    addCycleBenchmarks(registry);
+    addPlatformBenchmarks(registry);
+
+    std::map<std::string, double> baseline;
+    if (baselinePath && !readJson(baselinePath, baseline))
+    {
+        std::fprintf(stderr, "bench: unable to read baseline '%s'\n", baselinePath);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Result> results;
+    unsigned regressions = 0;
+
+    if (!list)
+    {
+        std::fprintf(stderr, "%-44s %12s %12s", "benchmark", "ns/sample", "cm4 cyc/smp");
+        if (baselinePath) std::fprintf(stderr, " %12s %9s", "baseline ns", "change");
+        std::fprintf(stderr, "\n");
+    }
+
+    for (const auto& benchmark : registry)
+    {
+        if (filter && std::string::npos == benchmark.name.find(filter)) continue;
+        if (list)
+        {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+
+        Result result;
+        result.name = benchmark.name;
+        result.nsPerSample = measure(benchmark, minSeconds);
+        result.cm4CyclesPerSample = result.nsPerSample * cm4Scale;
+        results.push_back(result);
+
+        std::fprintf(stderr, "%-44s %12.4f %12.2f", result.name.c_str(), result.nsPerSample, result.cm4CyclesPerSample);
+        auto base = baseline.find(result.name);
+        if (base != baseline.end() && base->second > 0.0)
+        {
+            const double change = 100.0 * (result.nsPerSample - base->second) / base->second;
+            const bool regressed = (maxRegression >= 0.0) && (change > maxRegression);
+            if (regressed) ++regressions;
+            std::fprintf(stderr, " %12.4f %+8.1f%%%s", base->second, change, regressed ? "  REGRESSION" : "");
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+    if (outputPath && !writeJson(outputPath, results, cm4Scale))
+    {
+        std::fprintf(stderr, "bench: unable to write '%s'\n", outputPath);
+        return EXIT_FAILURE;
+    }
+
+    if (regressions)
+    {
+        std::fprintf(stderr, "bench: %u benchmark(s) regressed by more than %.1f%%\n", regressions, maxRegression);
+        return 1;
+    }
+
+    return EXIT_SUCCESS;
+}
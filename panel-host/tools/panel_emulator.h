@@ -0,0 +1,372 @@
+/** Scriptable front panel emulator for the host tools.
+ *
+ *  The emulator owns the firmware state structures (MainState, LfoState, EnvelopeState and
+ *  VcoStateArray). A host tool attaches each panel that should read them with
+ *  logue::BasicPanel::attach(memory()), and detaches it before the emulator is destroyed. A timeline
+ *  script moves the controls, and the emulator runs the LFO at the firmware's 40.5 kHz clock, so
+ *  the panel-reactive code sees realistic values.
+ *
+ *  BasicPanelEmulator is a template on the platform policy (see logue_internals.h), as BasicPanel is,
+ *  and PanelEmulator emulates the build's platform. The Prologue LFO has no one-shot mode, so on
+ *  that platform lfo.mode is ignored and the LFO always runs.
+ *
+ *  Script format, one event per line ('#' starts a comment):
+ *
+ *      <time> <control> <value> [<glide>]
+ *
+ *  Times and glides are in seconds. Without a glide, the control jumps to the value at the given
+ *  time; with one, it moves linearly from its current value over the glide time. Events are applied
+ *  at block boundaries. The controls and their value units are:
+ *
+ *      vco1.wave, vco2.wave        Waveform: 0=square, 1=triangle, 2=saw
+ *      vco1.shape, vco2.shape      Shape knob, [0, 1.0]
+ *      vco1.pitch, vco2.pitch      Pitch offset in semitones, eg -12 or 0.5
+ *      lfo.wave                    Waveform: 0=square, 1=triangle, 2=saw
+ *      lfo.rate                    Rate in Hz
+ *      lfo.mode                    0=normal, 1=one-shot
+ *      lfo.trigger                 Restart the LFO (the value is ignored), as a key-on does
+ *      eg.level                    Modulation EG output level, [0, 1.0]
+ *      eg.intensity                Filter EG intensity, [-1.0, 1.0]
+ *      filter.cutoff               Filter cutoff knob, [0, 1.0]
+ *      filter.resonance            Filter resonance knob, [0, 1.0]
+ *
+ *  For example, a triangle LFO at 6 Hz with a VCO 1 shape sweep and a waveform change:
+ *
+ *      0       lfo.wave        1
+ *      0       lfo.rate        6
+ *      0       vco1.shape      0
+ *      1       vco1.shape      1       2.5
+ *      2       vco2.wave       0
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "logue_internals.h"
+
+namespace host
+{
+    template <typename Platform> class BasicPanelEmulator
+    {
+    public:
+
+        typedef typename Platform::MainState        MainState;
+        typedef typename Platform::LfoState         LfoState;
+        typedef typename Platform::EnvelopeState    EnvelopeState;
+        typedef typename Platform::VcoStateArray    VcoStateArray;
+
+        static const uint32_t kSampleRate = 48000;
+        static const uint32_t kLfoClock = uint32_t(Platform::kLfoClockHz);
+
+
+        BasicPanelEmulator()
+        {
+            std::memset(&m_lfo, 0, sizeof m_lfo);
+            std::memset(&m_envelope, 0, sizeof m_envelope);
+            std::memset(&m_vco, 0, sizeof m_vco);
+
+            // The same neutral values as logue::Panel uses for unrecognised firmware, with a running LFO.
+            m_main = Platform::mainStateDefaults();
+            setActive(m_lfo, true);
+
+            m_memory.main = &m_main;
+            m_memory.lfo = &m_lfo;
+            m_memory.envelope = &m_envelope;
+            m_memory.vco = &m_vco;
+        }
+
+        BasicPanelEmulator(const BasicPanelEmulator&) = delete;
+        BasicPanelEmulator& operator=(const BasicPanelEmulator&) = delete;
+
+
+        /** Parse a timeline script, replacing any previous one.
+         *
+         *  @param  text        The script.
+         *  @param  error       Receives a description of the first error.
+         *  @return             Logical true on success.
+         */
+        bool parse(const char* text, std::string& error)
+        {
+            m_events.clear();
+            m_next = 0;
+            m_glides.clear();
+
+            unsigned lineNumber = 0;
+            while (*text)
+            {
+                const char* end = std::strchr(text, '\n');
+                if (!end) end = text + std::strlen(text);
+                std::string line(text, end);
+                text = *end ? end + 1 : end;
+                ++lineNumber;
+
+                const size_t comment = line.find('#');
+                if (comment != std::string::npos) line.erase(comment);
+
+                char name[64];
+                Event event;
+                event.glide = 0.0;
+                const int fields = std::sscanf(line.c_str(), "%lf %63s %lf %lf", &event.time, name, &event.value, &event.glide);
+                if (fields <= 0) continue;
+                if (fields < 3 || event.time < 0.0 || event.glide < 0.0 || !findControl(name, event.control))
+                {
+                    error = "line " + std::to_string(lineNumber) + ": cannot parse '" + line + "'";
+                    return false;
+                }
+                m_events.push_back(event);
+            }
+
+            std::stable_sort(m_events.begin(), m_events.end(), [](const Event& a, const Event& b) { return a.time < b.time; });
+            return true;
+        }
+
+
+        /** Load a timeline script from a file.
+         *
+         *  @param  path        The script file.
+         *  @param  error       Receives a description of the first error.
+         *  @return             Logical true on success.
+         */
+        bool load(const char* path, std::string& error)
+        {
+            FILE* file = std::fopen(path, "rb");
+            if (!file)
+            {
+                error = std::string("unable to open '") + path + "'";
+                return false;
+            }
+            std::string text;
+            char buffer[4096];
+            size_t count;
+            while (0 != (count = std::fread(buffer, 1, sizeof buffer, file))) text.append(buffer, count);
+            std::fclose(file);
+            return parse(text.c_str(), error);
+        }
+
+
+        /** Advance the panel by one block. Call before each OSC_CYCLE.
+         *
+         *  @param  frames      The number of frames in the block.
+         */
+        void advance(uint32_t frames)
+        {
+            const double time = double(m_frame) / kSampleRate;
+
+            // Start the events that are due, then move the gliding controls.
+            for (; m_next != m_events.size() && m_events[m_next].time <= time; ++m_next)
+            {
+                const Event& event = m_events[m_next];
+                m_glides.erase(std::remove_if(m_glides.begin(), m_glides.end(), [&](const Glide& glide) { return glide.control == event.control; }), m_glides.end());
+                if (event.glide > 0.0) m_glides.push_back({ event.control, get(event.control), event.value, event.time, event.glide });
+                else set(event.control, event.value);
+            }
+            for (size_t i = 0; i != m_glides.size(); )
+            {
+                const Glide& glide = m_glides[i];
+                const double position = (time - glide.start) / glide.duration;
+                if (position >= 1.0)
+                {
+                    set(glide.control, glide.to);
+                    m_glides.erase(m_glides.begin() + i);
+                }
+                else
+                {
+                    set(glide.control, glide.from + (glide.to - glide.from) * position);
+                    ++i;
+                }
+            }
+
+            // Run the LFO interrupt for the ticks that fall in this block.
+            m_lfoClockRemainder += uint64_t(frames) * kLfoClock;
+            const uint64_t ticks = m_lfoClockRemainder / kSampleRate;
+            m_lfoClockRemainder %= kSampleRate;
+            if (active(m_lfo))
+            {
+                const uint64_t phase = uint64_t(m_lfo.phaseValue) + ticks * m_lfo.phaseDelta;
+                if (oneShot(m_lfo) && phase >= 0x80000000u)
+                {
+                    // One-shot: stop at the end of the half-cycle.
+                    m_lfo.phaseValue = 0x7fffffffu;
+                    setActive(m_lfo, false);
+                }
+                else
+                {
+                    m_lfo.phaseValue = uint32_t(phase);
+                }
+            }
+
+            m_frame += frames;
+        }
+
+
+        /** Restart the timeline from time zero, keeping the current control values. Glides in progress stop.
+         */
+        void rewind()
+        {
+            m_next = 0;
+            m_glides.clear();
+            m_frame = 0;
+        }
+
+
+        double time() const { return double(m_frame) / kSampleRate; }     ///< The timeline position, in seconds.
+
+
+        MainState& main() { return m_main; }                            ///< Direct access to the emulated state.
+        LfoState& lfo() { return m_lfo; }                               ///<
+        EnvelopeState& envelope() { return m_envelope; }                ///<
+        VcoStateArray& vco() { return m_vco; }                          ///<
+        const logue::BasicHostPanelMemory<Platform>& memory() const { return m_memory; }   ///< The structures, for BasicPanel::attach() or BasicPanelTraceWriter.
+
+
+    private:
+
+        enum Control
+        {
+            kVco1Wave, kVco2Wave, kVco1Shape, kVco2Shape, kVco1Pitch, kVco2Pitch,
+            kLfoWave, kLfoRate, kLfoMode, kLfoTrigger,
+            kEgLevel, kEgIntensity, kFilterCutoff, kFilterResonance,
+        };
+
+        struct Event
+        {
+            double      time;
+            Control     control;
+            double      value;
+            double      glide;
+        };
+
+        struct Glide
+        {
+            Control     control;
+            double      from;
+            double      to;
+            double      start;
+            double      duration;
+        };
+
+
+        static bool findControl(const char* name, Control& control)
+        {
+            static const struct { const char* name; Control control; } controls[] =
+            {
+                { "vco1.wave",          kVco1Wave },
+                { "vco2.wave",          kVco2Wave },
+                { "vco1.shape",         kVco1Shape },
+                { "vco2.shape",         kVco2Shape },
+                { "vco1.pitch",         kVco1Pitch },
+                { "vco2.pitch",         kVco2Pitch },
+                { "lfo.wave",           kLfoWave },
+                { "lfo.rate",           kLfoRate },
+                { "lfo.mode",           kLfoMode },
+                { "lfo.trigger",        kLfoTrigger },
+                { "eg.level",           kEgLevel },
+                { "eg.intensity",       kEgIntensity },
+                { "filter.cutoff",      kFilterCutoff },
+                { "filter.resonance",   kFilterResonance },
+            };
+            for (const auto& entry : controls)
+            {
+                if (0 == std::strcmp(name, entry.name))
+                {
+                    control = entry.control;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+
+        // The LFO run state and one-shot mode, which only the Minilogue XD has: the Prologue LFO always runs.
+        static bool active(const logue::LfoState_Prologue_210&) { return true; }
+        static bool active(const logue::LfoState_Minilogue_210& lfo) { return lfo.active != 0; }
+        static void setActive(logue::LfoState_Prologue_210&, bool) {}
+        static void setActive(logue::LfoState_Minilogue_210& lfo, bool active) { lfo.active = uint8_t(active); }
+        static bool oneShot(const logue::LfoState_Prologue_210&) { return false; }
+        static bool oneShot(const logue::LfoState_Minilogue_210& lfo) { return (lfo.mode & 1) != 0; }
+        static void setOneShot(logue::LfoState_Prologue_210&, bool) {}
+        static void setOneShot(logue::LfoState_Minilogue_210& lfo, bool oneShot) { lfo.mode = uint8_t(oneShot); }
+
+
+        static double clamp(double value, double low, double high) { return (value < low) ? low : (value > high) ? high : value; }
+
+
+        /** Write a control, converting from script units to the firmware representation.
+         */
+        void set(Control control, double value)
+        {
+            auto& engine = m_main.engine[0];
+            switch (control)
+            {
+                case kVco1Wave:         engine.vco[0].waveform = uint8_t(clamp(value, 0.0, 2.0));                   break;
+                case kVco2Wave:         engine.vco[1].waveform = uint8_t(clamp(value, 0.0, 2.0));                   break;
+                case kVco1Shape:        engine.vco[0].shape = uint32_t(clamp(value, 0.0, 1.0) * 0x2000 + 0.5);      break;
+                case kVco2Shape:        engine.vco[1].shape = uint32_t(clamp(value, 0.0, 1.0) * 0x2000 + 0.5);      break;
+                case kVco1Pitch:        engine.vco[0].pitch = int32_t(std::lround(value * 256.0));                  break;
+                case kVco2Pitch:        engine.vco[1].pitch = int32_t(std::lround(value * 256.0));                  break;
+                case kLfoWave:          m_lfo.waveform = uint8_t(clamp(value, 0.0, 2.0));
+                                        engine.lfoWaveform = m_lfo.waveform;                                        break;
+                case kLfoRate:          m_lfo.phaseDelta = uint32_t(clamp(value, 0.0, kLfoClock / 2.0) * 4294967296.0 / kLfoClock); break;
+                case kLfoMode:          setOneShot(m_lfo, value != 0.0);                                            break;
+                case kLfoTrigger:       m_lfo.phaseValue = 0; setActive(m_lfo, true);                               break;
+                case kEgLevel:          m_envelope.modulationEgLevel = uint32_t(clamp(value, 0.0, 1.0) * 4294967295.0); break;
+                case kEgIntensity:      m_envelope.filterEgIntensity1 = int32_t(clamp(value, -1.0, 1.0) * 0x20000);
+                                        m_envelope.filterEgIntensity2 = m_envelope.filterEgIntensity1;
+                                        engine.filterEgIntensity = uint16_t(0x1000 + clamp(value, -1.0, 1.0) * 0x1000); break;
+                case kFilterCutoff:     engine.filterCutoffControl = uint16_t(clamp(value, 0.0, 1.0) * 0x2000 + 0.5); break;
+                case kFilterResonance:  engine.filterResonanceControl = uint16_t(clamp(value, 0.0, 1.0) * 0x2000 + 0.5); break;
+            }
+        }
+
+
+        /** Read a control back in script units, as the starting point of a glide.
+         */
+        double get(Control control) const
+        {
+            const auto& engine = m_main.engine[0];
+            switch (control)
+            {
+                case kVco1Wave:         return engine.vco[0].waveform;
+                case kVco2Wave:         return engine.vco[1].waveform;
+                case kVco1Shape:        return engine.vco[0].shape / double(0x2000);
+                case kVco2Shape:        return engine.vco[1].shape / double(0x2000);
+                case kVco1Pitch:        return engine.vco[0].pitch / 256.0;
+                case kVco2Pitch:        return engine.vco[1].pitch / 256.0;
+                case kLfoWave:          return m_lfo.waveform;
+                case kLfoRate:          return m_lfo.phaseDelta * double(kLfoClock) / 4294967296.0;
+                case kLfoMode:          return oneShot(m_lfo);
+                case kLfoTrigger:       return 0.0;
+                case kEgLevel:          return m_envelope.modulationEgLevel / 4294967295.0;
+                case kEgIntensity:      return m_envelope.filterEgIntensity1 / double(0x20000);
+                case kFilterCutoff:     return engine.filterCutoffControl / double(0x2000);
+                case kFilterResonance:  return engine.filterResonanceControl / double(0x2000);
+            }
+            return 0.0;
+        }
+
+
+    private:
+
+        MainState                   m_main;
+        LfoState                    m_lfo;
+        EnvelopeState               m_envelope;
+        VcoStateArray               m_vco;
+        logue::BasicHostPanelMemory<Platform> m_memory;
+
+        std::vector<Event>          m_events;
+        size_t                      m_next              { 0 };      // The next event to apply
+        std::vector<Glide>          m_glides;
+        uint64_t                    m_frame             { 0 };
+        uint64_t                    m_lfoClockRemainder { 0 };      // LFO clock ticks * kSampleRate not yet applied
+    };
+
+    typedef BasicPanelEmulator<logue::Platform> PanelEmulator;     ///< The emulator for the build's platform.
+
+}   // namespace
@@ -0,0 +1,311 @@
+/** Panel state traces: timestamped raw dumps of the firmware SRAM that holds the panel structures.
+ *
+ *  A trace is a 64 byte header followed by fixed size frames. Each frame is the sample time at
+ *  which the dump was taken followed by an unmodified copy of one SRAM region, so a capture from
+ *  the synth can be written out as it is read, and a replay can use the structures in place:
+ *
+ *      Offset      Size        Header field
+ *      0x00        8           kMagic, "LGPANEL1"
+ *      0x08        4           Layout (logue::kLayout210)
+ *      0x0c        4           Sample rate of the frame times (48000)
+ *      0x10        4           SRAM address of the start of the region
+ *      0x14        4           Region size in bytes
+ *      0x18        4           Frame stride in bytes: 8 + region size, rounded up to a multiple of 8
+ *      0x1c        4           SRAM address of MainState
+ *      0x20        4           SRAM address of LfoState
+ *      0x24        4           SRAM address of EnvelopeState
+ *      0x28        4           SRAM address of VcoStateArray
+ *      0x2c        4           Platform, as the SDK target (eg k_user_target_miniloguexd, 0x200)
+ *      0x30        16          Reserved, zero
+ *
+ *      0x00        8           Frame: sample time of the dump, strictly increasing
+ *      0x08        region      Frame: the SRAM region
+ *
+ *  All fields are little-endian. The number of frames follows from the file size, so a capture that
+ *  was cut short still replays up to its last complete frame. The platform matters as well as the
+ *  layout: the Prologue and Minilogue XD share kLayout210 but not their LfoState, so a trace only
+ *  replays on the platform that it was taken from. Firmware 2.10 keeps the structures in
+ *  0x20008850 to 0x20009f00 (see kFirmwareLayouts), which makes each frame a little under 6 kB.
+ *
+ *  BasicPanelTraceReader maps a trace into memory and provides a logue::BasicHostPanelMemory for each
+ *  frame that points straight into the mapping, so replaying a trace copies nothing.
+ *  BasicPanelTraceWriter writes one from host state, eg from BasicPanelEmulator. Both are templates
+ *  on the platform policy, as BasicPanel is, and PanelTraceReader and PanelTraceWriter are for the
+ *  build's platform.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logue_internals.h"
+
+namespace host
+{
+    struct PanelTraceHeader
+    {
+        char        magic[8];
+        uint32_t    layout;
+        uint32_t    sampleRate;
+        uint32_t    regionAddress;
+        uint32_t    regionSize;
+        uint32_t    frameStride;
+        uint32_t    mainAddress;
+        uint32_t    lfoAddress;
+        uint32_t    envelopeAddress;
+        uint32_t    vcoAddress;
+        uint32_t    platform;
+        uint32_t    reserved[4];
+    };
+
+    static_assert(sizeof (PanelTraceHeader) == 64, "The trace header is 64 bytes");
+
+    const char kPanelTraceMagic[8] = { 'L', 'G', 'P', 'A', 'N', 'E', 'L', '1' };
+
+    // Firmware 2.10 (Prologue and Minilogue XD): the region of SRAM and the structures within it.
+    const uint32_t kPanelTraceRegion210             = 0x20008850u;
+    const uint32_t kPanelTraceRegionSize210         = 0x20009f00u - 0x20008850u;
+    const uint32_t kPanelTraceMain210               = 0x20009e40u;
+    const uint32_t kPanelTraceLfo210                = 0x20008970u;
+    const uint32_t kPanelTraceEnvelope210           = 0x200089a0u;
+    const uint32_t kPanelTraceVco210                = 0x20008850u;
+
+
+    /** Read-only memory mapping of a trace taken from @e Platform.
+     */
+    template <typename Platform> class BasicPanelTraceReader
+    {
+    public:
+
+        typedef typename Platform::MainState        MainState;
+        typedef typename Platform::LfoState         LfoState;
+        typedef typename Platform::EnvelopeState    EnvelopeState;
+        typedef typename Platform::VcoStateArray    VcoStateArray;
+
+
+        ~BasicPanelTraceReader() { close(); }
+
+        BasicPanelTraceReader() = default;
+        BasicPanelTraceReader(const BasicPanelTraceReader&) = delete;
+        BasicPanelTraceReader& operator=(const BasicPanelTraceReader&) = delete;
+
+
+        /** Map a trace and check its header.
+         *
+         *  @param  path        The trace file.
+         *  @param  error       Receives a description of the problem on failure.
+         *  @return             Logical true on success.
+         */
+        bool open(const char* path, std::string& error)
+        {
+            close();
+
+            const int fd = ::open(path, O_RDONLY);
+            if (fd < 0)
+            {
+                error = std::string("unable to open '") + path + "'";
+                return false;
+            }
+            struct stat status;
+            if (0 != ::fstat(fd, &status) || size_t(status.st_size) < sizeof (PanelTraceHeader))
+            {
+                ::close(fd);
+                error = "not a panel trace";
+                return false;
+            }
+            void* data = ::mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED)
+            {
+                error = "unable to map the trace";
+                return false;
+            }
+            m_data = static_cast<const uint8_t*>(data);
+            m_size = size_t(status.st_size);
+
+            // Frames are read in order, once.
+            ::madvise(data, m_size, MADV_SEQUENTIAL);
+
+            std::memcpy(&m_header, m_data, sizeof m_header);
+            if (!checkHeader(error))
+            {
+                close();
+                return false;
+            }
+            m_frames = (m_size - sizeof m_header) / m_header.frameStride;
+            return true;
+        }
+
+        void close()
+        {
+            if (m_data) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+            m_data = nullptr;
+            m_size = 0;
+            m_frames = 0;
+        }
+
+
+        const PanelTraceHeader& header() const { return m_header; }
+        size_t frames() const { return m_frames; }                          ///< The number of complete frames.
+        size_t bytes() const { return m_size; }                             ///< The size of the mapping.
+
+
+        /** Return the sample time of a frame. The reader does not check that the times increase,
+         *  which would be a pass over the whole trace, so a replay checks each as it reaches it.
+         */
+        uint64_t time(size_t frame) const
+        {
+            uint64_t time;
+            std::memcpy(&time, this->frame(frame), sizeof time);
+            return time;
+        }
+
+
+        /** Return the structures in a frame, pointing into the mapping. They are valid until close().
+         */
+        logue::BasicHostPanelMemory<Platform> memory(size_t frame) const
+        {
+            const uint8_t* region = this->frame(frame) + sizeof (uint64_t);
+            logue::BasicHostPanelMemory<Platform> memory;
+            memory.main     =   reinterpret_cast<const MainState*>(region + (m_header.mainAddress - m_header.regionAddress));
+            memory.lfo      =   reinterpret_cast<const LfoState*>(region + (m_header.lfoAddress - m_header.regionAddress));
+            memory.envelope =   reinterpret_cast<const EnvelopeState*>(region + (m_header.envelopeAddress - m_header.regionAddress));
+            memory.vco      =   reinterpret_cast<const VcoStateArray*>(region + (m_header.vcoAddress - m_header.regionAddress));
+            return memory;
+        }
+
+
+    private:
+
+        const uint8_t* frame(size_t frame) const { return m_data + sizeof m_header + frame * m_header.frameStride; }
+
+        bool checkHeader(std::string& error) const
+        {
+            const PanelTraceHeader& h = m_header;
+            if (0 != std::memcmp(h.magic, kPanelTraceMagic, sizeof h.magic))
+            {
+                error = "not a panel trace";
+                return false;
+            }
+            if (h.layout != Platform::kLayout || h.sampleRate != 48000)
+            {
+                error = "the trace is for a different layout or sample rate";
+                return false;
+            }
+            if (h.platform != Platform::kTarget)
+            {
+                error = "the trace is for a different platform";
+                return false;
+            }
+
+            // Every structure must lie inside the region and be aligned, so that it can be used in place.
+            const bool ok = (h.frameStride % 8) == 0 && h.frameStride >= sizeof (uint64_t) + h.regionSize
+                && contains(h.mainAddress, sizeof (MainState), alignof (MainState))
+                && contains(h.lfoAddress, sizeof (LfoState), alignof (LfoState))
+                && contains(h.envelopeAddress, sizeof (EnvelopeState), alignof (EnvelopeState))
+                && contains(h.vcoAddress, sizeof (VcoStateArray), alignof (VcoStateArray));
+            if (!ok) error = "the trace header is inconsistent";
+            return ok;
+        }
+
+        bool contains(uint32_t address, size_t size, size_t alignment) const
+        {
+            const uint64_t offset = uint64_t(address) - m_header.regionAddress;
+            return address >= m_header.regionAddress && offset + size <= m_header.regionSize
+                && ((sizeof (uint64_t) + offset) % alignment) == 0;
+        }
+
+
+    private:
+
+        const uint8_t*      m_data          { nullptr };
+        size_t              m_size          { 0 };
+        size_t              m_frames        { 0 };
+        PanelTraceHeader    m_header;
+    };
+
+    typedef BasicPanelTraceReader<logue::Platform> PanelTraceReader;   ///< The trace reader for the build's platform.
+
+
+    /** Streaming trace output for @e Platform, for the firmware 2.10 region.
+     */
+    template <typename Platform> class BasicPanelTraceWriter
+    {
+    public:
+
+        ~BasicPanelTraceWriter() { close(); }
+
+        BasicPanelTraceWriter() = default;
+        BasicPanelTraceWriter(const BasicPanelTraceWriter&) = delete;
+        BasicPanelTraceWriter& operator=(const BasicPanelTraceWriter&) = delete;
+
+
+        bool open(const char* path)
+        {
+            close();
+            m_file = std::fopen(path, "wb");
+            if (!m_file) return false;
+
+            PanelTraceHeader header;
+            std::memset(&header, 0, sizeof header);
+            std::memcpy(header.magic, kPanelTraceMagic, sizeof header.magic);
+            header.layout           =   Platform::kLayout;
+            header.sampleRate       =   48000;
+            header.regionAddress    =   kPanelTraceRegion210;
+            header.regionSize       =   kPanelTraceRegionSize210;
+            header.frameStride      =   (uint32_t(sizeof (uint64_t)) + kPanelTraceRegionSize210 + 7u) & ~7u;
+            header.mainAddress      =   kPanelTraceMain210;
+            header.lfoAddress       =   kPanelTraceLfo210;
+            header.envelopeAddress  =   kPanelTraceEnvelope210;
+            header.vcoAddress       =   kPanelTraceVco210;
+            header.platform         =   Platform::kTarget;
+
+            m_frame.assign(header.frameStride, 0);
+            return 1 == std::fwrite(&header, sizeof header, 1, m_file);
+        }
+
+
+        /** Append a frame. Parts of the region outside the structures are written as zero.
+         *
+         *  @param  time        The sample time of the frame, greater than the previous one.
+         *  @param  memory      The structures to dump.
+         *  @return             Logical true on success.
+         */
+        bool write(uint64_t time, const logue::BasicHostPanelMemory<Platform>& memory)
+        {
+            uint8_t* region = &m_frame[sizeof time];
+            std::memcpy(&m_frame[0], &time, sizeof time);
+            std::memcpy(region + (kPanelTraceMain210 - kPanelTraceRegion210), memory.main, sizeof *memory.main);
+            std::memcpy(region + (kPanelTraceLfo210 - kPanelTraceRegion210), memory.lfo, sizeof *memory.lfo);
+            std::memcpy(region + (kPanelTraceEnvelope210 - kPanelTraceRegion210), memory.envelope, sizeof *memory.envelope);
+            std::memcpy(region + (kPanelTraceVco210 - kPanelTraceRegion210), memory.vco, sizeof *memory.vco);
+            return 1 == std::fwrite(m_frame.data(), m_frame.size(), 1, m_file);
+        }
+
+
+        bool close()
+        {
+            if (!m_file) return true;
+            const bool ok = (0 == std::fclose(m_file));
+            m_file = nullptr;
+            return ok;
+        }
+
+
+    private:
+
+        FILE*                   m_file      { nullptr };
+        std::vector<uint8_t>    m_frame;
+    };
+
+    typedef BasicPanelTraceWriter<logue::Platform> PanelTraceWriter;   ///< The trace writer for the build's platform.
+
+}   // namespace
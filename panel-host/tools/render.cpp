@@ -0,0 +1,335 @@
+/** Offline renderer for the host build.
+ *
+ *  Calls OSC_INIT once and then OSC_CYCLE in 64 frame blocks, stepping through a pitch sequence
+ *  and applying shape/shift-shape automation via OSC_PARAM. The Q31 output is streamed to a WAV or
+ *  raw file block by block, so renders of any length run in constant memory. On completion the
+ *  throughput of the OSC_CYCLE calls is reported as samples/sec and as a real-time factor.
+ *
+ *  Usage: render [options] <output.wav|output.raw|->
+ *
+ *      -s, --seconds <n>           Render length in seconds (default 10).
+ *      -p, --pitch <list>          Comma separated note sequence, eg "60,64,67.5" (default 60).
+ *                                  Fractional notes are converted to the Q7.8 fine byte.
+ *      -d, --step <seconds>        Duration of each note in the sequence (default 0.5).
+ *      -a, --shape <list>          Shape automation as time:value breakpoints, eg "0:0,4:1023".
+ *      -b, --shift-shape <list>    Shift-shape automation, same format as --shape.
+ *      -u, --unison <percent>      Unison detune, [0, 100] (parameter 1). Zero (the default) is off.
+ *      -m, --shape-mode <mode>     What the VCO shape controls (parameter 2): 0 for phase modulation
+ *                                  (the default), 1 for the wavefolder or 2 for the saturator.
+ *      -f, --format <wav|raw>      Output format. Defaults to the file extension, or raw for stdout.
+ *      -P, --panel <script>        Drive the panel state from a timeline script (see panel_emulator.h).
+ *                                  Without it, the panel reads as the neutral defaults.
+ *      -R, --record <trace>        With --panel, write the panel state of each block to a trace for
+ *                                  replay (see panel_trace.h).
+ *      -q, --quiet                 Do not print the throughput report.
+ *
+ *  Automation values are OSC_PARAM values [0, 1023], linearly interpolated between breakpoints and
+ *  held after the last. Raw output is native-endian int32 Q31.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "userosc.h"
+#include "demo_engine.h"
+#include "audio_file_writer.h"
+#include "panel_emulator.h"
+#include "panel_trace.h"
+
+namespace
+{
+    const uint32_t kSampleRate = 48000;
+    const uint32_t kBlockFrames = 64;
+
+
+    /** Piecewise linear automation curve.
+     */
+    class Automation
+    {
+    public:
+
+        bool parse(const char* text)
+        {
+            m_points.clear();
+            while (*text)
+            {
+                char* end;
+                Point point;
+                point.time = std::strtod(text, &end);
+                if (end == text || *end != ':') return false;
+                text = end + 1;
+                point.value = std::strtod(text, &end);
+                if (end == text) return false;
+                if (!m_points.empty() && point.time < m_points.back().time) return false;
+                m_points.push_back(point);
+                text = end;
+                if (*text == ',') ++text;
+                else if (*text) return false;
+            }
+            return !m_points.empty();
+        }
+
+        bool empty() const { return m_points.empty(); }
+
+        uint16_t valueAt(double time) const
+        {
+            double value = m_points.back().value;
+            for (size_t i = 0; i != m_points.size(); ++i)
+            {
+                if (time < m_points[i].time)
+                {
+                    if (i == 0) value = m_points[0].value;
+                    else
+                    {
+                        const Point& a = m_points[i - 1];
+                        const Point& b = m_points[i];
+                        value = a.value + (b.value - a.value) * (time - a.time) / (b.time - a.time);
+                    }
+                    break;
+                }
+            }
+            if (value < 0.0) value = 0.0;
+            else if (value > 1023.0) value = 1023.0;
+            return uint16_t(value + 0.5);
+        }
+
+    private:
+
+        struct Point
+        {
+            double time;
+            double value;
+        };
+
+        std::vector<Point> m_points;
+    };
+
+
+    /** Parse a comma separated list of notes to Q7.8 pitch values.
+     */
+    bool parsePitches(const char* text, std::vector<uint16_t>& pitches)
+    {
+        pitches.clear();
+        while (*text)
+        {
+            char* end;
+            double note = std::strtod(text, &end);
+            if (end == text || note < 0.0 || note >= 128.0) return false;
+            pitches.push_back(uint16_t(note * 256.0 + 0.5));
+            text = end;
+            if (*text == ',') ++text;
+            else if (*text) return false;
+        }
+        return !pitches.empty();
+    }
+
+
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: render [options] <output.wav|output.raw|->\n"
+            "  -s, --seconds <n>           render length in seconds (default 10)\n"
+            "  -p, --pitch <list>          note sequence, eg \"60,64,67.5\" (default 60)\n"
+            "  -d, --step <seconds>        duration of each note (default 0.5)\n"
+            "  -a, --shape <list>          shape automation, eg \"0:0,4:1023\"\n"
+            "  -b, --shift-shape <list>    shift-shape automation\n"
+            "  -u, --unison <percent>      unison detune, [0, 100] (default 0)\n"
+            "  -m, --shape-mode <mode>     0 modulation, 1 fold, 2 saturate (default 0)\n"
+            "  -f, --format <wav|raw>      output format (default from extension)\n"
+            "  -P, --panel <script>        panel timeline script\n"
+            "  -R, --record <trace>        with --panel, record the panel state to a trace\n"
+            "  -q, --quiet                 no throughput report\n");
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    double seconds = 10.0;
+    double step = 0.5;
+    std::vector<uint16_t> pitches(1, 60 << 8);
+    Automation shape;
+    Automation shiftShape;
+    int unison = 0;
+    int shapeMode = 0;
+    const char* format = nullptr;
+    const char* panelScript = nullptr;
+    const char* tracePath = nullptr;
+    bool quiet = false;
+
+    static const struct option options[] =
+    {
+        { "seconds",        required_argument,  nullptr,    's' },
+        { "pitch",          required_argument,  nullptr,    'p' },
+        { "step",           required_argument,  nullptr,    'd' },
+        { "shape",          required_argument,  nullptr,    'a' },
+        { "shift-shape",    required_argument,  nullptr,    'b' },
+        { "unison",         required_argument,  nullptr,    'u' },
+        { "shape-mode",     required_argument,  nullptr,    'm' },
+        { "format",         required_argument,  nullptr,    'f' },
+        { "panel",          required_argument,  nullptr,    'P' },
+        { "record",         required_argument,  nullptr,    'R' },
+        { "quiet",          no_argument,        nullptr,    'q' },
+        { nullptr,          0,                  nullptr,    0   }
+    };
+
+    int option;
+    while (-1 != (option = getopt_long(argc, argv, "s:p:d:a:b:u:m:f:P:R:q", options, nullptr)))
+    {
+        bool ok = true;
+        switch (option)
+        {
+            case 's':   seconds = std::atof(optarg); ok = seconds > 0.0;    break;
+            case 'p':   ok = parsePitches(optarg, pitches);                 break;
+            case 'd':   step = std::atof(optarg); ok = step > 0.0;          break;
+            case 'a':   ok = shape.parse(optarg);                           break;
+            case 'b':   ok = shiftShape.parse(optarg);                      break;
+            case 'u':   unison = std::atoi(optarg); ok = unison >= 0 && unison <= 100; break;
+            case 'm':   shapeMode = std::atoi(optarg); ok = shapeMode >= 0 && shapeMode <= 2; break;
+            case 'f':   format = optarg; ok = (0 == std::strcmp(format, "wav")) || (0 == std::strcmp(format, "raw")); break;
+            case 'P':   panelScript = optarg;                               break;
+            case 'R':   tracePath = optarg;                                 break;
+            case 'q':   quiet = true;                                       break;
+            default:    ok = false;                                         break;
+        }
+        if (!ok)
+        {
+            if (optarg) std::fprintf(stderr, "render: invalid argument '%s'\n", optarg);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind + 1 != argc || (tracePath && !panelScript))
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const char* path = argv[optind];
+    bool wav;
+    if (format) wav = (0 == std::strcmp(format, "wav"));
+    else
+    {
+        size_t length = std::strlen(path);
+        wav = (length > 4) && (0 == std::strcmp(path + length - 4, ".wav"));
+    }
+
+    std::unique_ptr<host::PanelEmulator> panel;
+    if (panelScript)
+    {
+        std::string error;
+        panel.reset(new host::PanelEmulator);
+        if (!panel->load(panelScript, error))
+        {
+            std::fprintf(stderr, "render: %s: %s\n", panelScript, error.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    host::PanelTraceWriter trace;
+    if (tracePath && !trace.open(tracePath))
+    {
+        std::fprintf(stderr, "render: unable to open '%s'\n", tracePath);
+        return EXIT_FAILURE;
+    }
+
+    host::AudioFileWriter output;
+    if (!output.open(path, wav))
+    {
+        std::fprintf(stderr, "render: unable to open '%s'\n", path);
+        return EXIT_FAILURE;
+    }
+
+    const uint64_t totalFrames = uint64_t(seconds * kSampleRate + 0.5);
+    const uint64_t stepFrames = uint64_t(step * kSampleRate + 0.5) ? uint64_t(step * kSampleRate + 0.5) : 1;
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration cycleTime { 0 };
+    const auto start = Clock::now();
+
+    _entry(k_user_target_host_osc, k_user_api_1_1_0);
+    if (panel) demo::hostEngine().panel().attach(panel->memory());
+    if (unison) _hook_param(k_user_osc_param_id1, uint16_t(unison));
+    if (shapeMode) _hook_param(k_user_osc_param_id2, uint16_t(shapeMode));
+
+    user_osc_param_t params;
+    std::memset(&params, 0, sizeof params);
+    int32_t lastShape = -1;
+    int32_t lastShiftShape = -1;
+    int32_t block[kBlockFrames];
+
+    for (uint64_t frame = 0; frame < totalFrames; frame += kBlockFrames)
+    {
+        const uint32_t frames = uint32_t((totalFrames - frame) < kBlockFrames ? (totalFrames - frame) : kBlockFrames);
+        const double time = double(frame) / kSampleRate;
+
+        params.pitch = pitches[(frame / stepFrames) % pitches.size()];
+
+        // As on the synth, parameters are only sent when they change.
+        if (!shape.empty() && lastShape != shape.valueAt(time))
+        {
+            lastShape = shape.valueAt(time);
+            _hook_param(k_user_osc_param_shape, uint16_t(lastShape));
+        }
+        if (!shiftShape.empty() && lastShiftShape != shiftShape.valueAt(time))
+        {
+            lastShiftShape = shiftShape.valueAt(time);
+            _hook_param(k_user_osc_param_shiftshape, uint16_t(lastShiftShape));
+        }
+
+        if (panel) panel->advance(frames);
+        if (tracePath && !trace.write(frame, panel->memory()))
+        {
+            std::fprintf(stderr, "render: trace write failed\n");
+            return EXIT_FAILURE;
+        }
+
+        const auto t0 = Clock::now();
+        _hook_cycle(&params, block, frames);
+        cycleTime += Clock::now() - t0;
+
+        if (!output.write(block, frames))
+        {
+            std::fprintf(stderr, "render: write failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (panel) demo::hostEngine().panel().detach();
+
+    if (!output.close())
+    {
+        std::fprintf(stderr, "render: write failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!trace.close())
+    {
+        std::fprintf(stderr, "render: trace write failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!quiet)
+    {
+        const double cycleSeconds = std::chrono::duration<double>(cycleTime).count();
+        const double totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double audioSeconds = double(totalFrames) / kSampleRate;
+        std::fprintf(stderr, "rendered:        %llu samples (%.3f s of audio)\n", (unsigned long long)totalFrames, audioSeconds);
+        std::fprintf(stderr, "OSC_CYCLE time:  %.6f s\n", cycleSeconds);
+        std::fprintf(stderr, "total time:      %.6f s (including file output)\n", totalSeconds);
+        if (cycleSeconds > 0.0)
+        {
+            std::fprintf(stderr, "throughput:      %.0f samples/sec\n", double(totalFrames) / cycleSeconds);
+            std::fprintf(stderr, "real-time:       %.1fx (48 kHz)\n", audioSeconds / cycleSeconds);
+            std::fprintf(stderr, "per sample:      %.2f ns\n", 1.0e9 * cycleSeconds / double(totalFrames));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
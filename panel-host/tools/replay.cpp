@@ -0,0 +1,222 @@
+/** Panel trace replay for the host build.
+ *
+ *  Maps a panel trace (see panel_trace.h) and renders OSC_CYCLE against it: before each stretch of
+ *  blocks the panel is pointed at the next dump, in place in the mapping, so no panel state is
+ *  copied and traces of any length replay in constant memory. Each dump applies from its own time
+ *  until the next one, and the last applies for one block. Rendering runs as fast as it can, so a
+ *  long capture doubles as a regression input (with output) and as a profiling load (without).
+ *
+ *  Usage: replay [options] <trace> [<output.wav|output.raw|->]
+ *
+ *      -p, --pitch <note>          The note to play, eg 60 or 60.5 (default 60).
+ *      -a, --shape <value>         OSC_PARAM shape value, [0, 1023] (default 0).
+ *      -b, --shift-shape <value>   OSC_PARAM shift-shape value, [0, 1023] (default 0).
+ *      -n, --loops <n>             Replay the trace n times (default 1).
+ *      -f, --format <wav|raw>      Output format. Defaults to the file extension, or raw for stdout.
+ *      -q, --quiet                 Do not print the throughput report.
+ *
+ *  Without an output file, the samples are discarded.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+
+#include "userosc.h"
+#include "demo_engine.h"
+#include "audio_file_writer.h"
+#include "panel_trace.h"
+
+namespace
+{
+    const uint32_t kSampleRate = 48000;
+    const uint32_t kBlockFrames = 64;
+
+
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: replay [options] <trace> [<output.wav|output.raw|->]\n"
+            "  -p, --pitch <note>          note to play (default 60)\n"
+            "  -a, --shape <value>         shape value, [0, 1023] (default 0)\n"
+            "  -b, --shift-shape <value>   shift-shape value, [0, 1023] (default 0)\n"
+            "  -n, --loops <n>             replay the trace n times (default 1)\n"
+            "  -f, --format <wav|raw>      output format (default from extension)\n"
+            "  -q, --quiet                 no throughput report\n");
+    }
+
+
+    bool parseValue(const char* text, double low, double high, double& value)
+    {
+        char* end;
+        value = std::strtod(text, &end);
+        return end != text && *end == 0 && value >= low && value <= high;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    double note = 60.0;
+    double shape = 0.0;
+    double shiftShape = 0.0;
+    double loops = 1.0;
+    const char* format = nullptr;
+    bool quiet = false;
+
+    static const struct option options[] =
+    {
+        { "pitch",          required_argument,  nullptr,    'p' },
+        { "shape",          required_argument,  nullptr,    'a' },
+        { "shift-shape",    required_argument,  nullptr,    'b' },
+        { "loops",          required_argument,  nullptr,    'n' },
+        { "format",         required_argument,  nullptr,    'f' },
+        { "quiet",          no_argument,        nullptr,    'q' },
+        { nullptr,          0,                  nullptr,    0   }
+    };
+
+    int option;
+    while (-1 != (option = getopt_long(argc, argv, "p:a:b:n:f:q", options, nullptr)))
+    {
+        bool ok = true;
+        switch (option)
+        {
+            case 'p':   ok = parseValue(optarg, 0.0, 127.99, note);         break;
+            case 'a':   ok = parseValue(optarg, 0.0, 1023.0, shape);        break;
+            case 'b':   ok = parseValue(optarg, 0.0, 1023.0, shiftShape);   break;
+            case 'n':   ok = parseValue(optarg, 1.0, 1.0e9, loops);         break;
+            case 'f':   format = optarg; ok = (0 == std::strcmp(format, "wav")) || (0 == std::strcmp(format, "raw")); break;
+            case 'q':   quiet = true;                                       break;
+            default:    ok = false;                                         break;
+        }
+        if (!ok)
+        {
+            if (optarg) std::fprintf(stderr, "replay: invalid argument '%s'\n", optarg);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind + 1 != argc && optind + 2 != argc)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    host::PanelTraceReader trace;
+    std::string error;
+    if (!trace.open(argv[optind], error))
+    {
+        std::fprintf(stderr, "replay: %s: %s\n", argv[optind], error.c_str());
+        return EXIT_FAILURE;
+    }
+    if (trace.frames() == 0)
+    {
+        std::fprintf(stderr, "replay: %s: the trace has no frames\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    host::AudioFileWriter output;
+    const char* path = (optind + 2 == argc) ? argv[optind + 1] : nullptr;
+    if (path)
+    {
+        bool wav;
+        if (format) wav = (0 == std::strcmp(format, "wav"));
+        else
+        {
+            size_t length = std::strlen(path);
+            wav = (length > 4) && (0 == std::strcmp(path + length - 4, ".wav"));
+        }
+        if (!output.open(path, wav))
+        {
+            std::fprintf(stderr, "replay: unable to open '%s'\n", path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration cycleTime { 0 };
+    const auto start = Clock::now();
+
+    _entry(k_user_target_host_osc, k_user_api_1_1_0);
+    _hook_param(k_user_osc_param_shape, uint16_t(shape + 0.5));
+    _hook_param(k_user_osc_param_shiftshape, uint16_t(shiftShape + 0.5));
+
+    user_osc_param_t params;
+    std::memset(&params, 0, sizeof params);
+    params.pitch = uint16_t(note * 256.0 + 0.5);
+    int32_t block[kBlockFrames];
+
+    logue::Panel& panel = demo::hostEngine().panel();
+    uint64_t totalFrames = 0;
+    const size_t frames = trace.frames();
+    for (uint64_t loop = 0; loop != uint64_t(loops); ++loop)
+    {
+        uint64_t time = trace.time(0);
+        for (size_t i = 0; i != frames; ++i)
+        {
+            // Point the panel at the next dump. The structures live in the trace, so they outlive the replay.
+            // Each dump plays until the time of the next, which must be later.
+            panel.attach(trace.memory(i));
+            uint64_t remaining = kBlockFrames;
+            if (i + 1 != frames)
+            {
+                const uint64_t next = trace.time(i + 1);
+                if (next <= time)
+                {
+                    std::fprintf(stderr, "replay: %s: the frame times do not increase at frame %zu\n", argv[optind], i + 1);
+                    return EXIT_FAILURE;
+                }
+                remaining = next - time;
+                time = next;
+            }
+            while (remaining)
+            {
+                const uint32_t count = uint32_t(remaining < kBlockFrames ? remaining : kBlockFrames);
+
+                const auto t0 = Clock::now();
+                _hook_cycle(&params, block, count);
+                cycleTime += Clock::now() - t0;
+
+                if (path && !output.write(block, count))
+                {
+                    std::fprintf(stderr, "replay: write failed\n");
+                    return EXIT_FAILURE;
+                }
+                remaining -= count;
+                totalFrames += count;
+            }
+        }
+    }
+
+    panel.detach();
+
+    if (!output.close())
+    {
+        std::fprintf(stderr, "replay: write failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!quiet)
+    {
+        const double cycleSeconds = std::chrono::duration<double>(cycleTime).count();
+        const double totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double audioSeconds = double(totalFrames) / kSampleRate;
+        const double traceBytes = double(frames) * trace.header().frameStride * uint64_t(loops);
+        std::fprintf(stderr, "replayed:        %llu dumps, %.1f MB (%.3f s of audio)\n",
+                     (unsigned long long)(frames * uint64_t(loops)), traceBytes / 1.0e6, audioSeconds);
+        std::fprintf(stderr, "OSC_CYCLE time:  %.6f s\n", cycleSeconds);
+        std::fprintf(stderr, "total time:      %.6f s (including file output)\n", totalSeconds);
+        if (cycleSeconds > 0.0 && totalSeconds > 0.0)
+        {
+            std::fprintf(stderr, "trace rate:      %.1f MB/s\n", traceBytes / 1.0e6 / totalSeconds);
+            std::fprintf(stderr, "real-time:       %.1fx (48 kHz)\n", audioSeconds / cycleSeconds);
+            std::fprintf(stderr, "per sample:      %.2f ns\n", 1.0e9 * cycleSeconds / double(totalFrames));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
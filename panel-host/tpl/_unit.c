@@ -0,0 +1,60 @@
+/** Host oscillator entry template.
+ *
+ *  Equivalent of the SDK's tpl/_unit.c for host builds. There is no hook table or BSS to clear:
+ *  the host C runtime zero-fills BSS and runs the static constructors before main(). The entry
+ *  point simply forwards to the unit's initialisation hook, and weak defaults are provided for any
+ *  hooks that the unit does not implement.
+ */
+
+#include "userosc.h"
+
+void _entry(uint32_t platform, uint32_t api)
+{
+  _hook_init(platform, api);
+}
+
+__attribute__((weak))
+void _hook_init(uint32_t platform, uint32_t api)
+{
+  (void)platform;
+  (void)api;
+}
+
+__attribute__((weak))
+void _hook_cycle(const user_osc_param_t * const params, int32_t *yn, const uint32_t frames)
+{
+  (void)params;
+  (void)yn;
+  (void)frames;
+}
+
+__attribute__((weak))
+void _hook_on(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+__attribute__((weak))
+void _hook_off(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+__attribute__((weak))
+void _hook_mute(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+__attribute__((weak))
+void _hook_value(uint16_t value)
+{
+  (void)value;
+}
+
+__attribute__((weak))
+void _hook_param(uint16_t index, uint16_t value)
+{
+  (void)index;
+  (void)value;
+}
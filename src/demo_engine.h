@@ -0,0 +1,383 @@
+/** Demo oscillator engine.
+ */
+#pragma once
+
+#include "userosc.h"
+#include "logue_dsp.h"
+#include "logue_panel.h"
+#include "logue_lfo.h"
+#include "logue_shaper.h"
+#include "logue_voiceid.h"
+#include "demo_oscillator.h"
+#include "demo_oscillator_bank.h"
+
+
+// Build options:
+//
+//      DEMO_FUSED_MIX              Non-zero to render the two oscillators of the phase modulation mode in
+//                                  one pass (Oscillator::renderMix) rather than through a buffer. Off by
+//                                  default: on the host the fused loop is 5 to 15% slower, and it has not
+//                                  been measured on the M4.
+//
+#if !defined(DEMO_FUSED_MIX)
+#define DEMO_FUSED_MIX              (0)
+#endif
+
+
+namespace demo
+{
+    /** The complete demo signal chain: the panel interface, two oscillators and the mix control.
+     *
+     *  All state is held in the instance, so any number of engines can coexist. The platform is a
+     *  policy from logue_internals.h, which selects the panel implementation; demo::Engine is the engine
+     *  for the build's platform, and the SDK entry points in main.cpp forward to a single static
+     *  instance of it. A host build can instantiate the engines for the other platforms alongside.
+     */
+    template <typename Platform> class BasicEngine
+    {
+    public:
+
+        /** Start of day initialisation. Resets the oscillators and the control state.
+         *
+         *  @param  platform        The platform (usrprg.h), eg k_user_target_miniloguexd_osc.
+         *  @param  api             The API version (usrprg.h), eg k_user_api_1_1_0
+         */
+        void init(uint32_t platform, uint32_t api)
+        {
+            (void)platform;
+            (void)api;
+
+            logue::VoiceID voiceID;
+            auto x = int32_t(voiceID()) >> 28;  // Q7.8 in range [-16, +15]
+            if (x >= 0) x += 1;                 // Q7.8 in range [-16, -1] or [1, 16] (because real instruments are never exactly in tune)
+
+            m_osc0 = Oscillator();
+            m_osc1 = Oscillator();
+            m_unison0 = UnisonBank(voiceID());
+            m_unison1 = UnisonBank(~voiceID());
+            m_shaper0 = logue::AdaaShaper();
+            m_shaper1 = logue::AdaaShaper();
+            m_detune = x;
+            m_shape = 0.0f;
+            m_shiftShape = 0.0f;
+            m_unison = 0.0f;
+            m_shapeMode = kShapeModulation;
+            m_mix.reset(0.0f);
+            m_lfo.setClock(m_panel.lfoClock());
+            m_panelTracker.reset();
+            m_pitch = -1;
+        }
+
+
+        /** Parameter change.
+         *
+         *  @param  index           The parameter number.
+         *  @param  value           The parameter value.
+         *
+         *  The value ranges for parameters 1-6 depend on how the parameter is configured in manifest.json:
+         *
+         *  For percentage parameters with +ve min:                     (0,100)         =>      (0,100)
+         *  For percentage parameters with -ve min:, use offset 100:    (-100,100)      =>      (0,200)
+         *  For typeless:                                               (0,99)          =>      (1,100)
+         *
+         *  The value range for shape and shift-shape is 0-0x3ff (10 bits unsigned).
+         */
+        void param(uint16_t index, uint16_t value)
+        {
+            if (k_user_osc_param_id1 == index)
+            {
+                // Unison: percentage, [0, 100]. The spread is scaled by +/-25% by the voice-card detune.
+                // The banks are only kept up to date while unison is on, so when it is switched on,
+                // the VCO inputs are applied to them again on the next cycle.
+                if (value > 100) value = 100;
+                if (m_unison == 0.0f && value != 0) m_panelTracker.reset();
+                m_unison = float(value) * 0.01f;
+                const float detune = m_unison * (1.0f + float(m_detune) * (1.0f / 64.0f));
+                m_unison0.setDetune(detune);
+                m_unison1.setDetune(detune);
+            }
+            else if (k_user_osc_param_id2 == index)
+            {
+                // Shape mode: typeless, [0, 2]. The VCO shape values are routed again on the next cycle.
+                if (value > kShapeSaturate) value = kShapeSaturate;
+                if (value != m_shapeMode)
+                {
+                    m_shapeMode = value;
+                    if (value != kShapeModulation)
+                    {
+                        m_shaper0.setCurve(value == kShapeFold ? logue::AdaaShaper::Fold : logue::AdaaShaper::Saturate);
+                        m_shaper1.setCurve(value == kShapeFold ? logue::AdaaShaper::Fold : logue::AdaaShaper::Saturate);
+                    }
+                    m_panelTracker.reset();
+                }
+            }
+            else if (k_user_osc_param_shape == index)
+            {
+                if (value > 1023) value = 1023;
+                m_shape = logue::u32ToFloat<10>(value);
+            }
+            else if (k_user_osc_param_shiftshape == index)
+            {
+                if (value > 1023) value = 1023;
+                m_shiftShape = logue::u32ToFloat<10>(value);
+            }
+        }
+
+
+        /** Generate sample data.
+         *
+         *  @param  params      The current oscillator parameters.
+         *  @param  yn          Pointer to memory to receive the samples (Q31 format, real-only).
+         *  @param  frames      The number of sample frames to generate.
+         */
+        void cycle(const user_osc_param_t* const params, int32_t* yn, const uint32_t frames)
+        {
+            // Capture the panel state once, so that all values come from the same instant. The oscillator
+            // setup below only runs for the inputs that have changed since the previous block.
+            typedef logue::PanelTracker Dirty;
+            logue::PanelSnapshot panel;
+            m_panel.validate();
+            m_panel.capture(panel);
+            const uint32_t dirty = m_panelTracker.update(panel);
+            const bool pitchChanged = (int32_t(params->pitch) != m_pitch);
+            const bool unison = (m_unison != 0.0f);
+            m_pitch = int32_t(params->pitch);
+
+
+            // Setup pitch.
+            if (pitchChanged || (dirty & Dirty::kVcoPitch0))
+            {
+                auto pitch0 = int32_t(params->pitch);           // Multi-engine pitch
+                pitch0 += m_detune;                             // Add voice-card dependent detune
+                pitch0 += panel.vcoPitch[0];                    // Add VCO pitch
+                m_osc0.setPitch(pitch0);
+                if (unison) m_unison0.setPitch(pitch0);
+            }
+
+            if (pitchChanged || (dirty & Dirty::kVcoPitch1))
+            {
+                auto pitch1 = int32_t(params->pitch);           // Multi-engine pitch
+                pitch1 -= m_detune;                             // Subtract voice-card dependent detune
+                pitch1 += panel.vcoPitch[1];                    // Add VCO pitch
+                m_osc1.setPitch(pitch1);
+                if (unison) m_unison1.setPitch(pitch1);
+            }
+
+
+            // Set the waveform. As for the pitch and shape, the unison banks are only updated while unison is on.
+            if (dirty & Dirty::kVcoWaveform0)
+            {
+                m_osc0.setWaveform(panel.vcoWaveform[0]);
+                if (unison) m_unison0.setWaveform(panel.vcoWaveform[0]);
+            }
+            if (dirty & Dirty::kVcoWaveform1)
+            {
+                m_osc1.setWaveform(panel.vcoWaveform[1]);
+                if (unison) m_unison1.setWaveform(panel.vcoWaveform[1]);
+            }
+
+
+            // Set the shape. Note the range of the VCO shape values is [0, 0x2000] (Q18.13 fixed point). In
+            // the fold and saturate modes the shape sets the shaper drive, and there is no phase modulation.
+            if (dirty & Dirty::kVcoShape0)
+            {
+                const float shape0 = logue::u32ToFloat<13>(panel.vcoShape[0]);
+                const float modulation0 = (m_shapeMode == kShapeModulation) ? shape0 : 0.0f;
+                m_osc0.setModulation(modulation0);
+                if (unison) m_unison0.setModulation(modulation0);
+                m_shaper0.setDrive(shape0);
+            }
+            if (dirty & Dirty::kVcoShape1)
+            {
+                const float shape1 = logue::u32ToFloat<13>(panel.vcoShape[1]);
+                const float modulation1 = (m_shapeMode == kShapeModulation) ? shape1 : 0.0f;
+                m_osc1.setModulation(modulation1);
+                if (unison) m_unison1.setModulation(modulation1);
+                m_shaper1.setDrive(shape1);
+            }
+
+
+            // Calculate the mix between the two oscillators, applying modulation. The normal approach would be
+            // to use the params->shape_lfo field, but here we read the LFO directly and apply a modulation
+            // intensity that is set via the shift-shape control. The shape control glides to its target, and
+            // the LFO is extrapolated to a per-sample phase so that fast rates do not step at the block rate.
+            DSP_ASSERT(frames <= 64);
+            m_mix.setTarget(m_shape, frames);
+#if DEMO_FUSED_MIX
+            if (m_unison == 0.0f && m_shapeMode == kShapeModulation)
+            {
+                // Both oscillators, the mix and the output conversion in one loop, with no buffer.
+                if (m_shiftShape == 0.0f && m_mix.settled())
+                {
+                    logue::SmoothConstant mix(m_mix.value());
+                    Oscillator::renderMix(m_osc0, m_osc1, mix, 0.9f, yn, frames);
+                }
+                else
+                {
+                    m_lfo.begin(panel);
+                    MixSource mix(m_mix, m_lfo, panel.lfoWaveform, m_shiftShape);
+                    Oscillator::renderMix(m_osc0, m_osc1, mix, 0.9f, yn, frames);
+                    mix.store(m_mix, m_lfo);
+                }
+                return;
+            }
+#endif
+
+            // VCO 1 is rendered to a buffer (as a bank of detuned voices in unison) and shaped if
+            // required. VCO 2 is then shaped and crossfaded into the same buffer one sample at a time,
+            // with the mix generated alongside.
+            float buffer[64];
+            if (m_unison != 0.0f) m_unison0.render(buffer, frames);
+            else m_osc0.render(buffer, frames);
+            if (m_shapeMode != kShapeModulation) m_shaper0.render(buffer, frames);
+
+            if (m_shiftShape == 0.0f && m_mix.settled())
+            {
+                // No modulation: the shape control is already in [0, 1.0].
+                logue::SmoothConstant mix(m_mix.value());
+                renderShapedCrossfade(buffer, frames, mix);
+            }
+            else
+            {
+                m_lfo.begin(panel);
+                MixSource mix(m_mix, m_lfo, panel.lfoWaveform, m_shiftShape);
+                renderShapedCrossfade(buffer, frames, mix);
+                mix.store(m_mix, m_lfo);
+            }
+
+            logue::floatToS32_saturating<31>(buffer, yn, frames);
+        }
+
+
+        logue::BasicPanel<Platform>& panel() { return m_panel; }     ///< The panel, eg for a host tool to attach().
+
+
+    private:
+
+        /** The per-sample mix for the render loops: the smoothed shape control plus the LFO,
+         *  [0, 1.0]. This is the read side of the logue_smoother.h interface. It works on copies of the
+         *  engine's control state, so that the render loop keeps them in registers, and store() writes
+         *  them back after the block. The LFO waveform is fixed for the block, and selected without a
+         *  call (see logue::Lfo::FirmwareShape).
+         */
+        class MixSource
+        {
+        public:
+
+            MixSource(const logue::OnePoleSmoother& mix, const logue::LfoReader& phase, unsigned waveform, float depth)
+                : m_mix(mix), m_phase(phase), m_shape(waveform), m_scale(depth * (1.0f / 2147483648.0f)) {}
+
+            void store(logue::OnePoleSmoother& mix, logue::LfoReader& phase) const
+            {
+                mix = m_mix;
+                phase = m_phase;
+            }
+
+            bool settled() const { return false; }
+            float value() const { return m_mix.value(); }   ///< The shape control, without the LFO.
+
+            DSP_INLINE float tick()
+            {
+                auto value = m_mix.tick() + float(m_shape.sample(m_phase.tick())) * m_scale;
+                if (value < 0.0f) value = 0.0f;
+                else if (value > 1.0f) value = 1.0f;
+                return value;
+            }
+
+        private:
+
+            logue::OnePoleSmoother  m_mix;
+            logue::LfoReader        m_phase;
+            logue::Lfo::FirmwareShape m_shape;
+            float                   m_scale;        // The LFO depth, per unit of Q31
+        };
+
+
+        /** The VCO 2 shaper stage for the modulation shape mode, which has no shaping.
+         */
+        struct Unshaped
+        {
+            Unshaped(const logue::AdaaShaper&, unsigned) {}
+            void store(logue::AdaaShaper&) const {}
+            DSP_INLINE float tick(float xn) const { return xn; }
+        };
+
+
+        /** The mixer for VCO 2 in renderCrossfade(): shape each sample with the @e Shaper stage and
+         *  crossfade it into the VCO 1 sample by the @e Mix smoother, with the output gain.
+         */
+        template <typename Shaper, typename Mix> struct Crossfade
+        {
+            DSP_INLINE void tick(float& yn, float xn)
+            {
+                const float x = shaper.tick(xn);
+                yn = 0.9f * (yn + mix.tick() * (x - yn));
+            }
+
+            Shaper      shaper;
+            Mix         mix;
+        };
+
+
+        /** Render VCO 2 with the shaper for the shape mode, and crossfade it into @e buffer.
+         */
+        template <typename Mix> void renderShapedCrossfade(float* buffer, unsigned frames, Mix& mix)
+        {
+            if (m_shapeMode == kShapeModulation) renderCrossfade<Unshaped>(buffer, frames, mix);
+            else if (m_shaper1.curve() == logue::AdaaShaper::Fold) renderCrossfade<logue::AdaaShaper::Stage<logue::ShapeFold>>(buffer, frames, mix);
+            else renderCrossfade<logue::AdaaShaper::Stage<logue::ShapeSaturate>>(buffer, frames, mix);
+        }
+
+
+        /** Render VCO 2, as a unison bank or a single oscillator, and crossfade it into @e buffer, which
+         *  holds VCO 1.
+         */
+        template <typename Shaper, typename Mix> void renderCrossfade(float* buffer, unsigned frames, Mix& mix)
+        {
+            Crossfade<Shaper, Mix> mixer { Shaper(m_shaper1, frames), mix };
+            if (m_unison != 0.0f) m_unison1.render(buffer, frames, mixer);
+            else m_osc1.render(buffer, frames, mixer);
+            mixer.shaper.store(m_shaper1);
+            mix = mixer.mix;
+        }
+
+
+        // Per-sample mix smoothing, 1 - 0.9^(1/64): the same ~13 ms time constant as the original
+        // per-block filter, which covered 10% of the distance each 64 sample block.
+        static constexpr float kMixSmoothing = 0.0016449037f;
+
+        // Voices per VCO in unison mode: the classic supersaw count.
+        static const unsigned kUnisonVoices = 7;
+        typedef OscillatorBank<kUnisonVoices> UnisonBank;
+
+        // What the VCO shape controls: parameter 2.
+        static const uint16_t kShapeModulation = 0;     // Phase modulation depth
+        static const uint16_t kShapeFold = 1;           // Wavefolder drive
+        static const uint16_t kShapeSaturate = 2;       // Saturator drive
+
+        logue::BasicPanel<Platform> m_panel     { logue::PanelValidation::Deferred };  // Checked from cycle(), so loading is instant
+        logue::PanelTracker     m_panelTracker;
+        Oscillator              m_osc0;
+        Oscillator              m_osc1;
+        UnisonBank              m_unison0;
+        UnisonBank              m_unison1;
+        logue::AdaaShaper       m_shaper0;
+        logue::AdaaShaper       m_shaper1;
+        int32_t                 m_detune        { 0 };
+        int32_t                 m_pitch         { -1 };         // params->pitch for the previous block, -1 if none
+        float                   m_shape         { 0.0f };
+        float                   m_shiftShape    { 0.0f };
+        float                   m_unison        { 0.0f };       // Unison detune, [0, 1.0]. Zero for a single voice per VCO.
+        uint16_t                m_shapeMode     { kShapeModulation };
+        logue::OnePoleSmoother  m_mix           { kMixSmoothing };  // The shape control, before LFO modulation
+        logue::LfoReader        m_lfo;
+    };
+
+
+    typedef BasicEngine<logue::Platform> Engine;       ///< The engine for the build's platform.
+
+#if PLATFORM_HOST
+    Engine& hostEngine();       ///< The instance behind the SDK entry points (main.cpp), for the host tools.
+#endif
+
+}   // namespace
@@ -3,16 +3,190 @@
 #pragma once
 
 #include "biquad.hpp"
+#include "logue_blep.h"
 #include "logue_dsp.h"
+#include "logue_oversampling.h"
+#include "logue_sine.h"
+#include "logue_pitch.h"
+#include "logue_smoother.h"
+
+
+// Build options:
+//
+//      DEMO_OVERSAMPLING           The demo::Oscillator oversampling factor: 1 (none, the default), 2 or 4.
+//      DEMO_OVERSAMPLING_QUALITY   The decimation filter grade, 0 to 2 (default 1), see logue_oversampling.h.
+//
+#if !defined(DEMO_OVERSAMPLING)
+#define DEMO_OVERSAMPLING           (1)
+#endif
+
+#if !defined(DEMO_OVERSAMPLING_QUALITY)
+#define DEMO_OVERSAMPLING_QUALITY   (1)
+#endif
+
 
 namespace demo
 {
+    /** Phase accumulator held as a float in cycles, [0, 1.0). Wrapping is an explicit compare and
+     *  subtract, and precision falls as the phase grows: at low notes the increment is a small
+     *  fraction of the float LSB near 1.0, so the pitch drifts slightly.
+     */
+    struct FloatPhase
+    {
+        typedef float Type;
+
+        static DSP_INLINE Type fromCycles(float cycles) { return cycles; }
+        static DSP_INLINE Type fromPhaseDelta(uint32_t delta) { return logue::u32ToFloat<32>(delta); }
+        static DSP_INLINE float toCycles(Type phase) { return phase; }
+
+        static DSP_INLINE Type advance(Type phase, Type delta)
+        {
+            phase += delta;
+            if (phase >= 1.0f) phase -= 1.0f;
+            return phase;
+        }
+
+        static DSP_INLINE Type offset(Type phase, float cycles)
+        {
+            // cycles: (-1.0, 1.0)
+            phase += cycles;
+            if (phase < 0.0f) phase += 1.0f;
+            else if (phase >= 1.0f) phase -= 1.0f;
+            return phase;
+        }
+
+        static DSP_INLINE float distance(Type from, Type to)
+        {
+            // The shorter way round, [0, 0.5].
+            float delta = to - from;
+            if (delta < -0.5f) delta += 1.0f;
+            else if (delta > 0.5f) delta -= 1.0f;
+            return (delta < 0.0f) ? -delta : delta;
+        }
+    };
+
+
+    /** Phase accumulator held as an unsigned UQ0.32 value. Wrapping is free modular overflow, the
+     *  phase modulation offset is added in the integer domain, and the resolution is uniform at
+     *  2^-32 cycles. All phase arithmetic is integer, so it is bit-identical on the host and M4.
+     */
+    struct IntegerPhase
+    {
+        typedef uint32_t Type;
+
+        static DSP_INLINE Type fromCycles(float cycles) { return logue::floatToU32<32>(cycles); }
+        static DSP_INLINE Type fromPhaseDelta(uint32_t delta) { return delta; }
+
+        // Only the top 24 bits are converted, so the result is exact and always < 1.0.
+        static DSP_INLINE float toCycles(Type phase) { return logue::u32ToFloat<24>(phase >> 8); }
+
+        static DSP_INLINE Type advance(Type phase, Type delta) { return phase + delta; }
+
+        static DSP_INLINE Type offset(Type phase, float cycles)
+        {
+            // cycles: (-1.0, 1.0). Converted as Q31 and doubled to Q32, losing only the bottom bit.
+            return phase + (uint32_t(logue::floatToS32<31>(cycles)) << 1);
+        }
+
+        static DSP_INLINE float distance(Type from, Type to)
+        {
+            // The shorter way round, [0, 0.5]: the modular difference, negated if it is over half a cycle.
+            uint32_t delta = to - from;
+            if (delta >> 31) delta = 0u - delta;
+            return logue::u32ToFloat<32>(delta);
+        }
+    };
+
+
+    /** The SDK sine, osc_sinf(), in the form of the logue_sine.h kernels.
+     */
+    struct SineSdk
+    {
+        static DSP_INLINE float sine(float phase) { return osc_sinf(phase); }
+    };
+
+
+    // Waveform kernels. Each provides the band-limit index for a note, and the sample for a phase given
+    // the phase increment since the previous sample and the band-limit index. The SDK kernels use the
+    // index, and also provide the SDK's half-period wave table for a whole index (k_wt_*_size + 1
+    // entries). WaveBlep adapts a logue_blep.h kernel, which uses the increment instead.
+    struct WaveSquare
+    {
+        static DSP_INLINE float bandLimit(float note) { return osc_bl_sqr_idx(note); }
+        static DSP_INLINE float sample(float phase, float, float bandLimit) { return osc_bl2_sqrf(phase, bandLimit); }
+        static DSP_INLINE const float* table(unsigned index) { return &wt_sqr_lut_f[index * k_wt_sqr_lut_size]; }
+    };
+
+    struct WaveParabola
+    {
+        static DSP_INLINE float bandLimit(float note) { return osc_bl_par_idx(note); }
+        static DSP_INLINE float sample(float phase, float, float bandLimit) { return osc_bl2_parf(phase, bandLimit); }
+        static DSP_INLINE const float* table(unsigned index) { return &wt_par_lut_f[index * k_wt_par_lut_size]; }
+    };
+
+    struct WaveSawtooth
+    {
+        static DSP_INLINE float bandLimit(float note) { return osc_bl_saw_idx(note); }
+        static DSP_INLINE float sample(float phase, float, float bandLimit) { return osc_bl2_sawf(phase, bandLimit); }
+        static DSP_INLINE const float* table(unsigned index) { return &wt_saw_lut_f[index * k_wt_saw_lut_size]; }
+    };
+
+    template <typename Kernel> struct WaveBlep
+    {
+        static DSP_INLINE float bandLimit(float) { return 0.0f; }
+        static DSP_INLINE float sample(float phase, float increment, float) { return Kernel::sample(phase, increment); }
+    };
+
+
+    // Waveform sets: the kernels for each waveform index. kTabulated is true if the kernels provide
+    // wave tables.
+    struct WavesSdk
+    {
+        static const bool kTabulated = true;
+
+        typedef WaveSquare      Square;
+        typedef WaveParabola    Parabola;
+        typedef WaveSawtooth    Sawtooth;
+    };
+
+    struct WavesBlep
+    {
+        static const bool kTabulated = false;
+
+        typedef WaveBlep<logue::BlepSquare>     Square;
+        typedef WaveBlep<logue::BlepParabola>   Parabola;
+        typedef WaveBlep<logue::BlepSawtooth>   Sawtooth;
+    };
+
+
+    /** The mixer for a plain render(): each new sample replaces the buffer contents. A mixer has a
+     *  single method, tick(yn, xn), which combines the new sample @e xn into the buffer sample @e yn.
+     */
+    struct MixReplace
+    {
+        DSP_INLINE void tick(float& yn, float xn) const { yn = xn; }
+    };
+
+
     /** Class used to implement a trivial oscillator.
      *
      *  This is not intended to be used as a real oscillator. Its purpose is to provide a means to
      *  demonstrate the Logue panel API.
+     *
+     *  @tparam Phase       The phase accumulator representation, FloatPhase or IntegerPhase.
+     *  @tparam Sine        The sine kernel used for the phase modulation: SineSdk or one of the
+     *                      logue_sine.h kernels.
+     *  @tparam Oversampler The logue::Oversampler decimation chain. The phase modulation adds sidebands
+     *                      above those the band-limited wave tables allow for, which alias at high notes
+     *                      and high shape values. Oversampled, the oscillator core runs kFactor times per
+     *                      output sample and the sidebands above 20 kHz are filtered out instead. The wave
+     *                      tables keep the band limit for the note at 48 kHz, so the waveform itself is
+     *                      unchanged; the polyBLEP waves band-limit for the sub-sample rate.
+     *  @tparam Waves       The waveform kernels: WavesSdk, the SDK's band-limited wave tables, or
+     *                      WavesBlep, the logue_blep.h kernels, which need no tables and are band
+     *                      limited by the actual phase increment, including the phase modulation.
      */
-    class Oscillator
+    template <typename Phase, typename Sine = SineSdk, typename Oversampler = logue::Oversampler<1>, typename Waves = WavesSdk> class BasicOscillator
     {
     public:
 
@@ -25,12 +199,13 @@ namespace demo
         {
             // index: [0, 2]
             m_waveformIndex = index;
+            updateBandLimit();
         }
 
 
         void setModulation(float modulation)
         {
-            // modulation: [0.0, 1.0]
+            // modulation: [0.0, 1.0]. The depth ramps to the new value over the next block.
             if (modulation < 0.0f) modulation = 0.0f;
             else if (modulation > 1.0f) modulation = 1.0f;
             m_modulation = modulation;
@@ -43,46 +218,207 @@ namespace demo
             if (pitch < 0) pitch = 0;
             else if (pitch >= 0x7fff) pitch = 0x7fff;
             m_note = logue::s32ToFloat<8>(pitch);
-            m_phaseDelta = osc_w0f_for_note(uint8_t(unsigned(pitch >> 8) & 0xffu), uint8_t(unsigned(pitch) & 0xffu));
+            const uint32_t phaseDelta = logue::PitchTable::phaseDelta(uint32_t(pitch));
+            m_phaseDelta = Phase::fromPhaseDelta(phaseDelta);
+            m_subPhaseDelta = Phase::fromPhaseDelta(phaseDelta / Oversampler::kFactor);
+            updateBandLimit();
         }
 
 
         void render(float* yn, unsigned frames)
         {
-            WaveFunction waveFunction;
-            float bandLimit;
+            MixReplace mixer;
+            render(yn, frames, mixer);
+        }
+
+
+        /** Render into a buffer through a mixer (eg MixReplace), which combines each new sample with
+         *  the one already in the buffer. This mixes a second signal into the buffer with no buffer of
+         *  its own. The mixer is copied to a local for the loop, and back afterwards.
+         *
+         *  @param  yn          The samples to combine with.
+         *  @param  frames      The number of sample frames to generate.
+         *  @param  mixer       The mixer.
+         */
+        template <typename Mixer> void render(float* yn, unsigned frames, Mixer& mixer)
+        {
+            // Select the waveform once per block. Each case is a separate, fully inlined render loop.
+            switch (m_waveformIndex)
+            {
+                case Square:        renderWave<typename Waves::Square>(yn, frames, mixer);     break;
+                case Parabola:      renderWave<typename Waves::Parabola>(yn, frames, mixer);   break;
+                case Sawtooth:      renderWave<typename Waves::Sawtooth>(yn, frames, mixer);   break;
+                default:            renderWave<typename Waves::Sawtooth>(yn, frames, mixer);   break;
+            }
+        }
+
+
+        /** Render two oscillators, mix them and write Q31 output in a single pass.
+         *
+         *  This is equivalent to rendering each oscillator to a float buffer and then mixing, but
+         *  both phases advance in the same loop and the result goes straight to @e yn, so no
+         *  intermediate buffers are needed. The waveform pair is selected once per block.
+         *
+         *  The mix is read from a logue_smoother.h smoother once per sample, so it ramps smoothly
+         *  across the block. When the smoother has settled, the loop runs with a constant mix.
+         *
+         *  The engine uses this only when built with DEMO_FUSED_MIX. On the host it is slower than the
+         *  buffered render (the bench 'mix/' cases), and the saving on the M4 has not been measured.
+         *
+         *  @param  osc0        The first oscillator.
+         *  @param  osc1        The second oscillator.
+         *  @param  mix         The mix smoother, [0, 1.0]: 0 for only @e osc0, 1.0 for only @e osc1.
+         *  @param  gain        The output gain.
+         *  @param  yn          Pointer to memory to receive the samples (Q31 format, clipped to [-1.0, +1.0)).
+         *  @param  frames      The number of sample frames to generate.
+         */
+        template <typename Smoother> static void renderMix(BasicOscillator& osc0, BasicOscillator& osc1, Smoother& mix, float gain, int32_t* yn, unsigned frames)
+        {
+            if (mix.settled())
+            {
+                logue::SmoothConstant constant(mix.value());
+                renderMixWave(osc0, osc1, constant, gain, yn, frames);
+            }
+            else
+            {
+                renderMixWave(osc0, osc1, mix, gain, yn, frames);
+            }
+        }
+
+
+    private:
+
+        typedef typename Phase::Type PhaseType;
+
 
+        /** Cache the band-limit index, which depends on both the note and the waveform.
+         */
+        void updateBandLimit()
+        {
             switch (m_waveformIndex)
             {
-                case Square:        waveFunction = &osc_bl2_sqrf;   bandLimit = osc_bl_sqr_idx(m_note);     break;
-                case Parabola:      waveFunction = &osc_bl2_parf;   bandLimit = osc_bl_par_idx(m_note);     break;
-                case Sawtooth:      waveFunction = &osc_bl2_sawf;   bandLimit = osc_bl_saw_idx(m_note);     break;
-                default:            waveFunction = &osc_bl2_sawf;   bandLimit = osc_bl_saw_idx(m_note);     break;
+                case Square:        m_bandLimit = Waves::Square::bandLimit(m_note);     break;
+                case Parabola:      m_bandLimit = Waves::Parabola::bandLimit(m_note);   break;
+                case Sawtooth:      m_bandLimit = Waves::Sawtooth::bandLimit(m_note);   break;
+                default:            m_bandLimit = Waves::Sawtooth::bandLimit(m_note);   break;
             }
+        }
+
+
+        /** Generate one sample of the oscillator core. The increment for the wave is the distance from
+         *  the previous modulated phase, @e lastPhase, so it includes the phase modulation, limited to
+         *  the range of the polyBLEP residuals. The SDK kernels ignore it, and then it compiles away.
+         */
+        template <typename Wave> static DSP_INLINE float sample(PhaseType phase, PhaseType& lastPhase, float mod, float bandLimit)
+        {
+            const PhaseType modulatedPhase = Phase::offset(phase, mod * Sine::sine(Phase::toCycles(phase)));
+            const float increment = clipmaxf(Phase::distance(lastPhase, modulatedPhase), 0.25f);
+            lastPhase = modulatedPhase;
+            return Wave::sample(Phase::toCycles(modulatedPhase), increment, bandLimit);
+        }
 
-            const auto mod = m_modulation * 0.75f;
+
+        /** Generate one output sample and advance the phase. When oversampled, the core runs at
+         *  kFactor sub-sample phases and the decimator reduces them to one sample. The phase itself
+         *  advances by the whole phase delta, so the pitch is exact whatever the factor.
+         */
+        template <typename Wave> static DSP_INLINE float tick(PhaseType& phase, PhaseType& lastPhase, PhaseType phaseDelta, PhaseType subPhaseDelta, float mod, float bandLimit, Oversampler& oversampler)
+        {
+            float xn[Oversampler::kFactor];
+            PhaseType subPhase = phase;
+            for (unsigned k = 0; k != Oversampler::kFactor; ++k)
+            {
+                xn[k] = sample<Wave>(subPhase, lastPhase, mod, bandLimit);
+                subPhase = Phase::advance(subPhase, subPhaseDelta);
+            }
+            phase = Phase::advance(phase, phaseDelta);
+            return oversampler.process(xn);
+        }
+
+
+        template <typename Wave, typename Mixer> DSP_INLINE void renderWave(float* yn, unsigned frames, Mixer& mixer)
+        {
+            const auto bandLimit = m_bandLimit;
+            m_depth.setTarget(m_modulation * 0.75f, frames);
+            auto depth = m_depth;
             const auto phaseDelta = m_phaseDelta;
+            const auto subPhaseDelta = m_subPhaseDelta;
             auto phase = m_phase;
+            auto lastPhase = m_lastPhase;
+            auto combine = mixer;
 
             for (unsigned i = 0; i != frames; ++i)
             {
-                float modulatedPhase = phase + (mod * osc_sinf(phase));
-                if (modulatedPhase < 0.0f) modulatedPhase += 1.0f;
-                else if (modulatedPhase >= 1.0f) modulatedPhase -= 1.0f;
+                combine.tick(yn[i], tick<Wave>(phase, lastPhase, phaseDelta, subPhaseDelta, depth.tick(), bandLimit, m_oversampler));
+            }
+
+            mixer = combine;
+            m_depth = depth;
+            m_phase = phase;
+            m_lastPhase = lastPhase;
+        }
 
-                yn[i] = (waveFunction)(modulatedPhase, bandLimit);
 
-                phase += phaseDelta;
-                if (phase >= 1.0f) phase -= 1.0f;
+        template <typename Mix> static void renderMixWave(BasicOscillator& osc0, BasicOscillator& osc1, Mix& mix, float gain, int32_t* yn, unsigned frames)
+        {
+            switch (osc0.m_waveformIndex)
+            {
+                case Square:        renderMixWave<typename Waves::Square>(osc0, osc1, mix, gain, yn, frames);     break;
+                case Parabola:      renderMixWave<typename Waves::Parabola>(osc0, osc1, mix, gain, yn, frames);   break;
+                case Sawtooth:      renderMixWave<typename Waves::Sawtooth>(osc0, osc1, mix, gain, yn, frames);   break;
+                default:            renderMixWave<typename Waves::Sawtooth>(osc0, osc1, mix, gain, yn, frames);   break;
             }
+        }
 
-            m_phase = phase;
+
+        template <typename Wave0, typename Mix> static DSP_INLINE void renderMixWave(BasicOscillator& osc0, BasicOscillator& osc1, Mix& mix, float gain, int32_t* yn, unsigned frames)
+        {
+            switch (osc1.m_waveformIndex)
+            {
+                case Square:        renderMixWave<Wave0, typename Waves::Square>(osc0, osc1, mix, gain, yn, frames);     break;
+                case Parabola:      renderMixWave<Wave0, typename Waves::Parabola>(osc0, osc1, mix, gain, yn, frames);   break;
+                case Sawtooth:      renderMixWave<Wave0, typename Waves::Sawtooth>(osc0, osc1, mix, gain, yn, frames);   break;
+                default:            renderMixWave<Wave0, typename Waves::Sawtooth>(osc0, osc1, mix, gain, yn, frames);   break;
+            }
         }
 
 
-    private:
+        template <typename Wave0, typename Wave1, typename Mix> static DSP_INLINE void renderMixWave(BasicOscillator& osc0, BasicOscillator& osc1, Mix& mix, float gain, int32_t* yn, unsigned frames)
+        {
+            const auto bandLimit0 = osc0.m_bandLimit;
+            osc0.m_depth.setTarget(osc0.m_modulation * 0.75f, frames);
+            auto depth0 = osc0.m_depth;
+            const auto phaseDelta0 = osc0.m_phaseDelta;
+            const auto subPhaseDelta0 = osc0.m_subPhaseDelta;
+            auto phase0 = osc0.m_phase;
+            auto lastPhase0 = osc0.m_lastPhase;
+
+            const auto bandLimit1 = osc1.m_bandLimit;
+            osc1.m_depth.setTarget(osc1.m_modulation * 0.75f, frames);
+            auto depth1 = osc1.m_depth;
+            const auto phaseDelta1 = osc1.m_phaseDelta;
+            const auto subPhaseDelta1 = osc1.m_subPhaseDelta;
+            auto phase1 = osc1.m_phase;
+            auto lastPhase1 = osc1.m_lastPhase;
+
+            auto smoother = mix;
+
+            for (unsigned i = 0; i != frames; ++i)
+            {
+                const float sample0 = tick<Wave0>(phase0, lastPhase0, phaseDelta0, subPhaseDelta0, depth0.tick(), bandLimit0, osc0.m_oversampler);
+                const float sample1 = tick<Wave1>(phase1, lastPhase1, phaseDelta1, subPhaseDelta1, depth1.tick(), bandLimit1, osc1.m_oversampler);
+                yn[i] = logue::floatToS32_saturating<31>(gain * (sample0 + smoother.tick() * (sample1 - sample0)));
+            }
+
+            mix = smoother;
+            osc0.m_depth = depth0;
+            osc1.m_depth = depth1;
+            osc0.m_phase = phase0;
+            osc0.m_lastPhase = lastPhase0;
+            osc1.m_phase = phase1;
+            osc1.m_lastPhase = lastPhase1;
+        }
 
-        typedef float (*WaveFunction)(float phase, float bandwidthLimiter);
 
         float noise()
         {
@@ -96,10 +432,23 @@ namespace demo
 
         unsigned    m_waveformIndex { 0 };                              // [0, 2]
         float       m_note          { 0 };                              // [0.0, 152.0]
-        float       m_phase         { 0.0f };                           // [0, 1.0)
-        float       m_phaseDelta    { 0.0f };                           // [0, 0.5]
+        float       m_bandLimit     { 0 };                              // osc_bl_*_idx(m_note) for the waveform
+        PhaseType   m_phase         { 0 };                              // [0, 1.0)
+        PhaseType   m_lastPhase     { 0 };                              // The last modulated phase, [0, 1.0)
+        PhaseType   m_phaseDelta    { 0 };                              // [0, 0.5]
+        PhaseType   m_subPhaseDelta { 0 };                              // m_phaseDelta / Oversampler::kFactor
         float       m_modulation    { 0.0f };                           // [0, 1.0]
+        logue::LinearSmoother m_depth;                                  // The phase modulation depth, 0.75 * m_modulation, ramped per sample
         uint32_t    m_noiseState    { 1 };                              // non-zero
+        Oversampler m_oversampler;
     };
 
+
+    /** The oscillator used by the demo engine. The 5th-order polynomial sine is both more accurate
+     *  and cheaper than osc_sinf(), see logue_sine.h, and the polyBLEP waves alias less than the SDK
+     *  wave tables under phase modulation, see logue_blep.h. The oversampling is set by the build
+     *  options.
+     */
+    typedef BasicOscillator<IntegerPhase, logue::SinePoly5, logue::Oversampler<DEMO_OVERSAMPLING, DEMO_OVERSAMPLING_QUALITY>, WavesBlep> Oscillator;
+
 }   // namespace
@@ -0,0 +1,372 @@
+/** Unison bank of demo oscillators.
+ */
+#pragma once
+
+#include "demo_oscillator.h"
+
+namespace demo
+{
+    /** N detuned copies of the demo oscillator, rendered together as one unison (supersaw style) voice.
+     *
+     *  The voices share the waveform and the phase modulation depth, and differ only in pitch and
+     *  phase. Their UQ0.32 phases and phase deltas are held as arrays (structure of arrays) and every
+     *  voice advances in the same sample loop. The voice loop has a compile time length, so the
+     *  compiler unrolls it: on the M4 the independent voices interleave in the pipeline, and on the
+     *  host the phase and sine arithmetic is vectorised across the voices.
+     *
+     *  The waves are the same kernels as demo::BasicOscillator's. With WavesBlep, the polyBLEP waves of
+     *  logue_blep.h, each voice is band-limited by its own modulated phase increment, as in the
+     *  oscillator, and the waveform is selected once per block. With WavesSdk the voices share the band
+     *  limit of the centre pitch, so most of the wave lookup is done once for the bank: the SDK's two
+     *  half-period tables are blended and unfolded to a full period when the pitch or waveform changes,
+     *  and each voice sample is a single interpolated lookup indexed straight from the integer phase.
+     *  The result is the same as osc_bl2_*f() to within float rounding. The table costs 516 bytes.
+     *  Unlike the oscillator, the bank is not oversampled.
+     *
+     *  The voices are spread about the centre pitch with the outer pair furthest out, by up to
+     *  kMaxSpread either side at a detune of 1.0. The output is the mean of the voices. The detuned
+     *  voices beat slowly and regularly drift back into phase, so anything louder than 1/N (such as
+     *  the 1/sqrt(N) that would hold the RMS level) saturates on those peaks.
+     *
+     *  @tparam N           The number of voices, [1, 16].
+     *  @tparam Sine        The sine kernel used for the phase modulation.
+     *  @tparam Waves       The waveform kernels, WavesSdk or WavesBlep, as for demo::BasicOscillator.
+     */
+    template <unsigned N, typename Sine = SineSdk, typename Waves = WavesSdk> class BasicOscillatorBank
+    {
+    public:
+
+        static_assert(N >= 1 && N <= 16, "the bank supports 1 to 16 voices");
+
+        static const unsigned kVoices = N;
+        static const int32_t kMaxSpread = 0x80;         ///< The outer voice offset at a detune of 1.0: Q7.8, 50 cents.
+
+
+        /** Constructor.
+         *
+         *  @param  seed        The seed for the starting phases, eg from logue::VoiceID.
+         */
+        explicit BasicOscillatorBank(uint32_t seed = 0)
+        {
+            reset(seed);
+            updateBandLimit();
+        }
+
+
+        /** Restart the voices with phases spread by a seed, so that they do not start in phase.
+         *
+         *  @param  seed        The seed for the starting phases.
+         */
+        void reset(uint32_t seed)
+        {
+            for (unsigned v = 0; v != N; ++v)
+            {
+                m_phase[v] = seed + v * 0x9e3779b9u;
+                m_lastPhase[v] = m_phase[v];
+            }
+        }
+
+
+        void setWaveform(unsigned index)
+        {
+            // index: [0, 2]
+            m_waveformIndex = index;
+            updateBandLimit();
+        }
+
+
+        void setModulation(float modulation)
+        {
+            // modulation: [0.0, 1.0]. The depth ramps to the new value over the next block.
+            if (modulation < 0.0f) modulation = 0.0f;
+            else if (modulation > 1.0f) modulation = 1.0f;
+            m_modulation = modulation;
+        }
+
+
+        void setPitch(int32_t pitch)
+        {
+            // pitch: MIDI note number in fixed point Q7.8
+            if (pitch < 0) pitch = 0;
+            else if (pitch >= 0x7fff) pitch = 0x7fff;
+            m_pitch = pitch;
+            m_note = logue::s32ToFloat<8>(pitch);
+            updatePitch();
+            updateBandLimit();
+        }
+
+
+        /** Set the spread of the voices about the centre pitch.
+         *
+         *  @param  detune      [0, 2.0]: 0 for all voices at the centre pitch, 1.0 for kMaxSpread.
+         */
+        void setDetune(float detune)
+        {
+            if (detune < 0.0f) detune = 0.0f;
+            else if (detune > 2.0f) detune = 2.0f;
+            m_detune = detune;
+            updatePitch();
+        }
+
+
+        /** Render the sum of the voices.
+         *
+         *  @param  yn          Receives the samples.
+         *  @param  frames      The number of sample frames to generate.
+         */
+        void render(float* yn, unsigned frames)
+        {
+            MixReplace mixer;
+            render(yn, frames, mixer);
+        }
+
+
+        /** Render the sum of the voices through a mixer, as BasicOscillator::render().
+         *
+         *  @param  yn          The samples to combine with.
+         *  @param  frames      The number of sample frames to generate.
+         *  @param  mixer       The mixer.
+         */
+        template <typename Mixer> void render(float* yn, unsigned frames, Mixer& mixer)
+        {
+            renderWaves(yn, frames, mixer, Tabulated<Waves::kTabulated>());
+        }
+
+
+    private:
+
+        template <bool> struct Tabulated {};
+
+
+        /** The per-voice wave for the shared table: one interpolated lookup.
+         */
+        struct TableVoice
+        {
+            static DSP_INLINE float sample(const float* table, uint32_t modulatedPhase, uint32_t& lastPhase)
+            {
+                (void)lastPhase;
+                const float* entry = &table[modulatedPhase >> (32 - kTableBits)];
+                const float fraction = logue::u32ToFloat<32 - kTableBits>(modulatedPhase & kFractionMask);
+                return entry[0] + fraction * (entry[1] - entry[0]);
+            }
+        };
+
+
+        /** The per-voice wave for the polyBLEP kernels, band-limited by the voice's own modulated phase
+         *  increment, as in BasicOscillator::sample().
+         */
+        template <typename Wave> struct BlepVoice
+        {
+            static DSP_INLINE float sample(const float* table, uint32_t modulatedPhase, uint32_t& lastPhase)
+            {
+                (void)table;
+                const float increment = clipmaxf(IntegerPhase::distance(lastPhase, modulatedPhase), 0.25f);
+                lastPhase = modulatedPhase;
+                return Wave::sample(IntegerPhase::toCycles(modulatedPhase), increment, 0.0f);
+            }
+        };
+
+
+        // The table is the same for every waveform, so there is a single render loop.
+        template <typename Mixer> void renderWaves(float* yn, unsigned frames, Mixer& mixer, Tabulated<true>)
+        {
+            renderVoices<TableVoice>(m_table.entries, yn, frames, mixer);
+        }
+
+
+        // Select the waveform once per block. Each case is a separate, fully inlined render loop.
+        template <typename Mixer> void renderWaves(float* yn, unsigned frames, Mixer& mixer, Tabulated<false>)
+        {
+            typedef BasicOscillator<IntegerPhase, Sine> Indices;
+            switch (m_waveformIndex)
+            {
+                case Indices::Square:       renderVoiceChunks<BlepVoice<typename Waves::Square>>(yn, frames, mixer);      break;
+                case Indices::Parabola:     renderVoiceChunks<BlepVoice<typename Waves::Parabola>>(yn, frames, mixer);    break;
+                case Indices::Sawtooth:     renderVoiceChunks<BlepVoice<typename Waves::Sawtooth>>(yn, frames, mixer);    break;
+                default:                    renderVoiceChunks<BlepVoice<typename Waves::Sawtooth>>(yn, frames, mixer);    break;
+            }
+        }
+
+
+        /** The render loop for the polyBLEP waves. Their residuals branch, and the voices interleaved
+         *  sample by sample run out of registers, so each voice renders a chunk of samples in turn into
+         *  a small sum buffer, which then goes through the mixer.
+         */
+        template <typename Voice, typename Mixer> DSP_INLINE void renderVoiceChunks(float* yn, unsigned frames, Mixer& mixer)
+        {
+            m_depth.setTarget(m_modulation * 0.75f, frames);
+            auto depth = m_depth;
+            auto combine = mixer;
+
+            for (unsigned start = 0; start < frames; start += kChunkFrames)
+            {
+                const unsigned count = (frames - start < kChunkFrames) ? frames - start : kChunkFrames;
+                float sum[kChunkFrames] = {};
+                auto voiceDepth = depth;
+                for (unsigned v = 0; v != N; ++v)
+                {
+                    voiceDepth = depth;
+                    uint32_t phase = m_phase[v];
+                    uint32_t lastPhase = m_lastPhase[v];
+                    const uint32_t phaseDelta = m_phaseDelta[v];
+                    for (unsigned i = 0; i != count; ++i)
+                    {
+                        const uint32_t modulatedPhase = IntegerPhase::offset(phase, voiceDepth.tick() * Sine::sine(IntegerPhase::toCycles(phase)));
+                        sum[i] += Voice::sample(nullptr, modulatedPhase, lastPhase);
+                        phase += phaseDelta;
+                    }
+                    m_phase[v] = phase;
+                    m_lastPhase[v] = lastPhase;
+                }
+                depth = voiceDepth;
+
+                for (unsigned i = 0; i != count; ++i) combine.tick(yn[start + i], sum[i] * kGain);
+            }
+
+            mixer = combine;
+            m_depth = depth;
+        }
+
+
+        template <typename Voice, typename Mixer> DSP_INLINE void renderVoices(const float* table, float* yn, unsigned frames, Mixer& mixer)
+        {
+            m_depth.setTarget(m_modulation * 0.75f, frames);
+            auto depth = m_depth;
+
+            alignas(16) uint32_t phase[N];
+            alignas(16) uint32_t lastPhase[N];
+            alignas(16) uint32_t phaseDelta[N];
+            for (unsigned v = 0; v != N; ++v)
+            {
+                phase[v] = m_phase[v];
+                lastPhase[v] = m_lastPhase[v];
+                phaseDelta[v] = m_phaseDelta[v];
+            }
+            auto combine = mixer;
+
+            for (unsigned i = 0; i != frames; ++i)
+            {
+                const float mod = depth.tick();
+                float sum = 0.0f;
+                for (unsigned v = 0; v != N; ++v)
+                {
+                    const uint32_t modulatedPhase = IntegerPhase::offset(phase[v], mod * Sine::sine(IntegerPhase::toCycles(phase[v])));
+                    sum += Voice::sample(table, modulatedPhase, lastPhase[v]);
+                    phase[v] += phaseDelta[v];
+                }
+                combine.tick(yn[i], sum * kGain);
+            }
+
+            mixer = combine;
+            m_depth = depth;
+            for (unsigned v = 0; v != N; ++v)
+            {
+                m_phase[v] = phase[v];
+                m_lastPhase[v] = lastPhase[v];
+            }
+        }
+
+        // One full period of the wave, from the SDK's half-period tables.
+        static const unsigned kTableBits = k_wt_saw_size_exp + 1;
+        static const unsigned kTableSize = 1u << kTableBits;
+        static const uint32_t kFractionMask = (1u << (32 - kTableBits)) - 1;
+
+        static_assert(k_wt_sqr_size_exp == k_wt_saw_size_exp && k_wt_par_size_exp == k_wt_saw_size_exp, "the wave tables must all be the same size");
+
+        static constexpr float kGain = 1.0f / float(N);
+        static const unsigned kChunkFrames = 16;       // Samples per voice in turn for the polyBLEP waves
+
+        // The shared wave table: one period, plus the first entry again. Only the tabulated waves have one.
+        template <bool IsTabulated, unsigned = 0> struct WaveTable { alignas(16) float entries[kTableSize + 1]; };
+        template <unsigned Unused> struct WaveTable<false, Unused> {};
+
+
+        /** The position of a voice in the spread, [-1.0, 1.0]. The cubic term pushes the outer voices
+         *  out and draws the inner ones together, approximating the classic supersaw spacing.
+         */
+        static float spread(unsigned voice)
+        {
+            if (N == 1) return 0.0f;
+            const float x = float(int(2 * voice) - int(N - 1)) / float(N - 1);
+            return x * (0.5f + 0.5f * x * x);
+        }
+
+
+        void updatePitch()
+        {
+            const float scale = m_detune * float(kMaxSpread);
+            for (unsigned v = 0; v != N; ++v)
+            {
+                int32_t pitch = m_pitch + int32_t(scale * spread(v));
+                if (pitch < 0) pitch = 0;
+                else if (pitch >= 0x7fff) pitch = 0x7fff;
+                m_phaseDelta[v] = logue::PitchTable::phaseDelta(uint32_t(pitch));
+            }
+        }
+
+
+        void updateBandLimit()
+        {
+            updateTable(Tabulated<Waves::kTabulated>());
+        }
+
+
+        // The polyBLEP waves need no table.
+        void updateTable(Tabulated<false>) {}
+
+
+        /** Rebuild the table for the band limit of the centre pitch. The spread is small enough that the
+         *  voices can share it.
+         */
+        void updateTable(Tabulated<true>)
+        {
+            switch (m_waveformIndex)
+            {
+                case BasicOscillator<IntegerPhase, Sine>::Square:       buildTable<WaveSquare>();       break;
+                case BasicOscillator<IntegerPhase, Sine>::Parabola:     buildTable<WaveParabola>();     break;
+                case BasicOscillator<IntegerPhase, Sine>::Sawtooth:     buildTable<WaveSawtooth>();     break;
+                default:                                                buildTable<WaveSawtooth>();     break;
+            }
+        }
+
+
+        template <typename Wave> void buildTable()
+        {
+            // Blend the two tables either side of the band-limit index, as osc_bl2_*f() does per sample,
+            // then unfold the odd-symmetric half period: entry kTableSize/2 + k is -entry kTableSize/2 - k.
+            const float bandLimit = Wave::bandLimit(m_note);
+            const unsigned index = unsigned(bandLimit);
+            const float fraction = bandLimit - float(index);
+            const float* table0 = Wave::table(index);
+            const float* table1 = Wave::table(index + 1);
+
+            const unsigned half = kTableSize / 2;
+            for (unsigned k = 0; k <= half; ++k)
+            {
+                const float value = table0[k] + fraction * (table1[k] - table0[k]);
+                m_table.entries[k] = value;
+                m_table.entries[kTableSize - k] = -value;
+            }
+        }
+
+
+    private:
+
+        alignas(16) uint32_t    m_phase[N];                         // UQ0.32
+        alignas(16) uint32_t    m_lastPhase[N];                     // The last modulated phases, UQ0.32, for WavesBlep
+        alignas(16) uint32_t    m_phaseDelta[N] {};                 // UQ0.32
+        WaveTable<Waves::kTabulated> m_table;                       // For WavesSdk
+        unsigned    m_waveformIndex { 0 };                          // [0, 2]
+        int32_t     m_pitch         { 0 };                          // The centre pitch, Q7.8
+        float       m_note          { 0 };                          // [0.0, 152.0]
+        float       m_modulation    { 0.0f };                       // [0, 1.0]
+        logue::LinearSmoother m_depth;                              // The phase modulation depth, 0.75 * m_modulation, ramped per sample
+        float       m_detune        { 0.0f };                       // [0, 2.0]
+    };
+
+
+    /** The unison bank used by the demo engine, with the same sine kernel and waves as demo::Oscillator.
+     */
+    template <unsigned N> using OscillatorBank = BasicOscillatorBank<N, logue::SinePoly5, WavesBlep>;
+
+}   // namespace
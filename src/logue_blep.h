@@ -0,0 +1,167 @@
+/** Band-limited waveforms for Logue by polynomial residuals (polyBLEP and polyBLAMP).
+ *
+ *  A naive waveform computed from the phase has discontinuities that alias. Adding a short polynomial
+ *  residual at each discontinuity, spread over the samples either side of it, replaces the ideal step
+ *  (BLEP) or corner (BLAMP) by a band-limited approximation. The residuals are functions of the
+ *  distance to the discontinuity measured in samples, so they are computed from the phase and the
+ *  phase increment per sample alone: there are no tables, everything inlines, and the same code runs
+ *  on the M4 and the host.
+ *
+ *  The increment is the magnitude of the phase step from the previous sample. Under phase modulation
+ *  it varies from sample to sample and the phase may momentarily run backwards; the residuals depend
+ *  only on the distance in phase to the discontinuity, so they apply in either direction.
+ *
+ *  Each kernel is a class with a single static method, sample(phase, increment), for a phase in
+ *  cycles, [0, 1.0), and an increment in cycles, [0, 0.25]. The waveforms match the shape, phase and
+ *  level of the SDK's osc_bl2_*f() waves:
+ *
+ *      Kernel              Waveform                                    Residual
+ *      BlepSawtooth        Falling saw, +1 at phase 0 to -1 at 1.0     polyBLEP, one per cycle
+ *      BlepSquare          +1 for the first half cycle, -1 after       polyBLEP, two per cycle
+ *      BlepParabola        8p(1 - 2p), negated in the second half      None: see below
+ *      BlepTriangle        0 at phase 0, +1 at 0.25, -1 at 0.75        polyBLAMP, two per cycle
+ *
+ *  The parabola is continuous with a continuous slope, and only its curvature steps, so its harmonics
+ *  fall at 18 dB per octave and the aliases are below -45 dB even at the top of the keyboard. The
+ *  residual for a step in the curvature, the integral of the corner residual, does not return to zero
+ *  after the discontinuity, so the parabola is computed directly. The triangle is not one of the SDK
+ *  waves, and is provided as an alternative.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+
+namespace logue
+{
+    /** The residuals for a discontinuity at phase 0 (and 1.0).
+     *
+     *  The band-limited step is the integral of a cubic B-spline, so it rises over four samples, two
+     *  either side of the discontinuity, and the residual is a quartic in the distance in samples. The
+     *  corner is the integral again, a quintic. The common two sample residual (the integral of a
+     *  linear spline) costs a little less but aliases 5 to 10 dB more, more than the SDK wave tables.
+     *  The residuals of neighbouring discontinuities add, and each applies as long as the increment is
+     *  at most 0.25 cycles per sample, a fundamental of 12 kHz.
+     */
+    struct PolyBlep
+    {
+        /** Return the residual for a unit rising step in the value.
+         *
+         *  @param  phase       The phase, [0, 1.0).
+         *  @param  increment   The phase increment per sample, [0, 0.25].
+         *  @return             The correction to add to the naive waveform.
+         */
+        static DSP_INLINE float step(float phase, float increment)
+        {
+            if (phase < 2.0f * increment) return -stepResidual(phase / increment);
+            if (phase > 1.0f - 2.0f * increment) return stepResidual((1.0f - phase) / increment);
+            return 0.0f;
+        }
+
+
+        /** Return the residual for a unit increase in the slope, in value per sample.
+         *
+         *  @param  phase       The phase, [0, 1.0).
+         *  @param  increment   The phase increment per sample, [0, 0.25].
+         *  @return             The correction to add to the naive waveform.
+         */
+        static DSP_INLINE float ramp(float phase, float increment)
+        {
+            if (phase < 2.0f * increment) return rampResidual(phase / increment);
+            if (phase > 1.0f - 2.0f * increment) return rampResidual((1.0f - phase) / increment);
+            return 0.0f;
+        }
+
+
+    private:
+
+        /** The step residual before the step, for a distance of @e t samples, [0, 2.0). After the step
+         *  it is the same, negated.
+         */
+        static DSP_INLINE float stepResidual(float t)
+        {
+            if (t < 1.0f)
+            {
+                return 0.5f + t * (-2.0f / 3.0f + t * t * (1.0f / 3.0f - t * 0.125f));
+            }
+            const float u = 2.0f - t;
+            const float u2 = u * u;
+            return u2 * u2 * (1.0f / 24.0f);
+        }
+
+
+        /** The ramp residual for a distance of @e t samples either side of the corner, [0, 2.0).
+         */
+        static DSP_INLINE float rampResidual(float t)
+        {
+            if (t < 1.0f)
+            {
+                return 7.0f / 30.0f + t * (-0.5f + t * (1.0f / 3.0f + t * t * (-1.0f / 12.0f + t * (1.0f / 40.0f))));
+            }
+            const float u = 2.0f - t;
+            const float u2 = u * u;
+            return u2 * u2 * u * (1.0f / 120.0f);
+        }
+    };
+
+
+    /** Falling sawtooth: a rising step of 2 at phase 0.
+     */
+    class BlepSawtooth
+    {
+    public:
+
+        DSP_INLINE static float sample(float phase, float increment)
+        {
+            return 1.0f - 2.0f * phase + 2.0f * PolyBlep::step(phase, increment);
+        }
+    };
+
+
+    /** Square: a rising step of 2 at phase 0 and a falling step of 2 at phase 0.5.
+     */
+    class BlepSquare
+    {
+    public:
+
+        DSP_INLINE static float sample(float phase, float increment)
+        {
+            const float halfPhase = (phase < 0.5f) ? phase + 0.5f : phase - 0.5f;
+            const float naive = (phase < 0.5f) ? 1.0f : -1.0f;
+            return naive + 2.0f * (PolyBlep::step(phase, increment) - PolyBlep::step(halfPhase, increment));
+        }
+    };
+
+
+    /** Parabola: two parabolic arcs of opposite sign, with no residual.
+     */
+    class BlepParabola
+    {
+    public:
+
+        DSP_INLINE static float sample(float phase, float increment)
+        {
+            (void)increment;
+            const float x = (phase < 0.5f) ? phase : phase - 0.5f;     // [0, 0.5)
+            const float y = 8.0f * x * (1.0f - 2.0f * x);
+            return (phase < 0.5f) ? y : -y;
+        }
+    };
+
+
+    /** Triangle: the slope steps by -8 per cycle at phase 0.25 and by +8 at 0.75.
+     */
+    class BlepTriangle
+    {
+    public:
+
+        DSP_INLINE static float sample(float phase, float increment)
+        {
+            // The phase relative to each corner, for the residuals. The slope steps by 8 * increment per sample.
+            const float peak = (phase < 0.25f) ? phase + 0.75f : phase - 0.25f;
+            const float trough = (phase < 0.75f) ? phase + 0.25f : phase - 0.75f;
+            const float naive = (phase < 0.25f) ? 4.0f * phase : (phase < 0.75f) ? 2.0f - 4.0f * phase : 4.0f * phase - 4.0f;
+            return naive + 8.0f * increment * (PolyBlep::ramp(trough, increment) - PolyBlep::ramp(peak, increment));
+        }
+    };
+
+}   // namespace
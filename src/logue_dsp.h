@@ -77,6 +77,16 @@
 
 
 
+// SIMD intrinsics for the vectorised conversions. X86_64 always has SSE2; AVX is used for the block
+// conversions when the compiler is targeting it (eg -mavx or -march=native).
+#if DSP_INTEL_X64
+#include <immintrin.h>
+#elif DSP_ARM_AARCH64
+#include <arm_neon.h>
+#endif
+
+
+
 // Macros to support common compiler and/or build-target specific optimisations.
 //
 //      DSP_INLINE              Use in place of the inline keyword to indicate that inlining should be a priority.
@@ -307,7 +317,8 @@ namespace logue
      *  @brief          Cast a float to an int32 with specified number of fractional bits, rounding towards zero, with saturation.
      *  @tparam fbits   The number of fractional integer bits in the output.
      *  @param  n       The float value.
-     *  @return         The corresponding saturated int32 value.
+     *  @return         The corresponding saturated int32 value. NaN gives the target's conversion: zero on
+     *                  the Cortex M4 and AArch64, INT32_MIN on X86_64.
      *
      *  Examples:
      *
@@ -399,6 +410,178 @@ namespace logue
 
 
 
+    /** @fn             template <unsigned fbits> static void floatToS32_saturating(const float* input, int32_t* output, unsigned count)
+     *  @brief          Convert a block of floats to int32 with specified number of fractional bits, rounding towards zero, with saturation.
+     *  @tparam fbits   The number of fractional integer bits in the output.
+     *  @param  input   The float values.
+     *  @param  output  Pointer to memory to receive the saturated int32 values. May be the same as @e input.
+     *  @param  count   The number of values to convert.
+     *
+     *  This is the block form of the scalar floatToS32_saturating(), with identical results. For example,
+     *  floatToS32_saturating<31>(in, out, 64) converts 64 samples to Q31, clipping at [-1.0, +1.0).
+     */
+
+
+    /** @fn             template <unsigned fbits> static void s32ToFloat(const int32_t* input, float* output, unsigned count)
+     *  @brief          Convert a block of int32 values with specified number of fractional bits to float.
+     *  @tparam fbits   The number of fractional integer bits in the input.
+     *  @param  input   The int32 values.
+     *  @param  output  Pointer to memory to receive the float values. May be the same as @e input.
+     *  @param  count   The number of values to convert.
+     */
+
+
+#if DSP_CORTEX_M4
+    // Block conversions for Cortex M4, four values per asm statement. The saturating vcvt works in
+    // place in the FPU registers, so each value is loaded, converted and stored without a round
+    // trip through the integer registers.
+#define DSP_CM4_FLOAT_TO_INTEGER_X4(output, input, fbits, type32)  do {                 \
+            float s0 = (input)[0], s1 = (input)[1], s2 = (input)[2], s3 = (input)[3];   \
+            asm ("vcvt." type32 ".f32 %[s0], %[s0], %[k_fbits]\n"                       \
+                 "vcvt." type32 ".f32 %[s1], %[s1], %[k_fbits]\n"                       \
+                 "vcvt." type32 ".f32 %[s2], %[s2], %[k_fbits]\n"                       \
+                 "vcvt." type32 ".f32 %[s3], %[s3], %[k_fbits]\n"                       \
+                 "vstr                %[s0], [%[r_output], #0]\n"                       \
+                 "vstr                %[s1], [%[r_output], #4]\n"                       \
+                 "vstr                %[s2], [%[r_output], #8]\n"                       \
+                 "vstr                %[s3], [%[r_output], #12]\n"                      \
+                 : [s0] "+t" (s0), [s1] "+t" (s1), [s2] "+t" (s2), [s3] "+t" (s3),      \
+                   "=m" (*reinterpret_cast<int32_t (*)[4]>(output))                     \
+                 : [r_output] "r" (output), [k_fbits] "n" (fbits));                     \
+        } while (false)
+
+#define DSP_CM4_INTEGER_TO_FLOAT_X4(output, input, fbits, type32)  do {                 \
+            float s0, s1, s2, s3;                                                       \
+            asm ("vldr                %[s0], [%[r_input], #0]\n"                        \
+                 "vldr                %[s1], [%[r_input], #4]\n"                        \
+                 "vldr                %[s2], [%[r_input], #8]\n"                        \
+                 "vldr                %[s3], [%[r_input], #12]\n"                       \
+                 "vcvt.f32." type32 " %[s0], %[s0], %[k_fbits]\n"                       \
+                 "vcvt.f32." type32 " %[s1], %[s1], %[k_fbits]\n"                       \
+                 "vcvt.f32." type32 " %[s2], %[s2], %[k_fbits]\n"                       \
+                 "vcvt.f32." type32 " %[s3], %[s3], %[k_fbits]\n"                       \
+                 : [s0] "=&t" (s0), [s1] "=&t" (s1), [s2] "=&t" (s2), [s3] "=&t" (s3)   \
+                 : [r_input] "r" (input), [k_fbits] "n" (fbits),                        \
+                   "m" (*reinterpret_cast<const int32_t (*)[4]>(input)));               \
+            (output)[0] = s0; (output)[1] = s1; (output)[2] = s2; (output)[3] = s3;     \
+        } while (false)
+
+    template <unsigned fbits> DSP_INLINE static void floatToS32_saturating(const float* input, int32_t* output, unsigned count)
+    {
+        for (; count >= 4; count -= 4, input += 4, output += 4) DSP_CM4_FLOAT_TO_INTEGER_X4(output, input, fbits, "s32");
+        for (; count; --count) *output++ = floatToS32_saturating<fbits>(*input++);
+    }
+
+    template <unsigned fbits> DSP_INLINE static void s32ToFloat(const int32_t* input, float* output, unsigned count)
+    {
+        for (; count >= 4; count -= 4, input += 4, output += 4) DSP_CM4_INTEGER_TO_FLOAT_X4(output, input, fbits, "s32");
+        for (; count; --count) *output++ = s32ToFloat<fbits>(*input++);
+    }
+
+    // As for the scalar versions, the assembler will not accept #0, so zero fractional bits use the scalar path.
+    template <> void DSP_INLINE floatToS32_saturating<0>(const float* input, int32_t* output, unsigned count)
+    {
+        for (; count; --count) *output++ = floatToS32_saturating<0>(*input++);
+    }
+
+    template <> void DSP_INLINE s32ToFloat<0>(const int32_t* input, float* output, unsigned count)
+    {
+        for (; count; --count) *output++ = s32ToFloat<0>(*input++);
+    }
+
+#elif DSP_INTEL_X64
+    // Block conversions for X86_64, eight values per step with AVX and four with SSE2. The results
+    // are identical to the scalar conversions.
+    template <unsigned fbits> DSP_INLINE static void floatToS32_saturating(const float* input, int32_t* output, unsigned count)
+    {
+        unsigned i = 0;
+#if defined(__AVX__)
+        const __m256 scale8 = _mm256_set1_ps(float(1ull << fbits));
+        const __m256 limit8 = _mm256_set1_ps(2147483648.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 x = _mm256_mul_ps(_mm256_loadu_ps(input + i), scale8);
+            const __m256 overflow = _mm256_cmp_ps(x, limit8, _CMP_GE_OQ);
+            const __m256 result = _mm256_xor_ps(_mm256_castsi256_ps(_mm256_cvttps_epi32(x)), overflow);
+            _mm256_storeu_ps(reinterpret_cast<float*>(output + i), result);
+        }
+#endif
+        const __m128 scale = _mm_set1_ps(float(1ull << fbits));
+        const __m128 limit = _mm_set1_ps(2147483648.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_mul_ps(_mm_loadu_ps(input + i), scale);
+            const __m128i overflow = _mm_castps_si128(_mm_cmpge_ps(x, limit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_xor_si128(_mm_cvttps_epi32(x), overflow));
+        }
+        for (; i != count; ++i) output[i] = floatToS32_saturating<fbits>(input[i]);
+    }
+
+    template <unsigned fbits> DSP_INLINE static void s32ToFloat(const int32_t* input, float* output, unsigned count)
+    {
+        unsigned i = 0;
+#if defined(__AVX__)
+        const __m256 scale8 = _mm256_set1_ps(1.0f / float(1ull << fbits));
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i n = _mm256_castps_si256(_mm256_loadu_ps(reinterpret_cast<const float*>(input + i)));
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(n), scale8));
+        }
+#endif
+        const __m128 scale = _mm_set1_ps(1.0f / float(1ull << fbits));
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(n), scale));
+        }
+        for (; i != count; ++i) output[i] = s32ToFloat<fbits>(input[i]);
+    }
+
+#elif DSP_ARM_AARCH64
+    // Block conversions for AArch64 NEON. The fixed-point vcvt saturates, as on the Cortex M4, and
+    // takes the fractional bit count as an immediate, which must be non-zero.
+    template <unsigned fbits> struct NeonFixedPoint
+    {
+        static DSP_INLINE int32x4_t toS32(float32x4_t x) { return vcvtq_n_s32_f32(x, fbits); }
+        static DSP_INLINE float32x4_t fromS32(int32x4_t n) { return vcvtq_n_f32_s32(n, fbits); }
+    };
+
+    template <> struct NeonFixedPoint<0>
+    {
+        static DSP_INLINE int32x4_t toS32(float32x4_t x) { return vcvtq_s32_f32(x); }
+        static DSP_INLINE float32x4_t fromS32(int32x4_t n) { return vcvtq_f32_s32(n); }
+    };
+
+    template <unsigned fbits> DSP_INLINE static void floatToS32_saturating(const float* input, int32_t* output, unsigned count)
+    {
+        unsigned i = 0;
+        for (; i + 4 <= count; i += 4) vst1q_s32(output + i, NeonFixedPoint<fbits>::toS32(vld1q_f32(input + i)));
+        for (; i != count; ++i) output[i] = floatToS32_saturating<fbits>(input[i]);
+    }
+
+    template <unsigned fbits> DSP_INLINE static void s32ToFloat(const int32_t* input, float* output, unsigned count)
+    {
+        unsigned i = 0;
+        for (; i + 4 <= count; i += 4) vst1q_f32(output + i, NeonFixedPoint<fbits>::fromS32(vld1q_s32(input + i)));
+        for (; i != count; ++i) output[i] = s32ToFloat<fbits>(input[i]);
+    }
+
+#else   // Platform independent block conversions.
+
+    template <unsigned fbits> DSP_INLINE static void floatToS32_saturating(const float* input, int32_t* output, unsigned count)
+    {
+        for (unsigned i = 0; i != count; ++i) output[i] = floatToS32_saturating<fbits>(input[i]);
+    }
+
+    template <unsigned fbits> DSP_INLINE static void s32ToFloat(const int32_t* input, float* output, unsigned count)
+    {
+        for (unsigned i = 0; i != count; ++i) output[i] = s32ToFloat<fbits>(input[i]);
+    }
+
+#endif
+
+
+
     /** Fast multiplication of a float by a integral power of two.
      *
      *  @param x    Initial value.
@@ -417,5 +600,35 @@ namespace logue
     }
 
 
+    /** Fast multiplication of a block of floats by an integral power of two.
+     *
+     *  @param input    The initial values.
+     *  @param output   Pointer to memory to receive the scaled values. May be the same as @e input.
+     *  @param count    The number of values.
+     *  @param y        The power of two to scale by.
+     *  @warning        As for the scalar version, the results are junk on overflow or underflow.
+     */
+    DSP_INLINE static void floatScaleByPow2(const float* input, float* output, unsigned count, int y)
+    {
+        unsigned i = 0;
+#if DSP_INTEL_X64
+        const __m128i exponent = _mm_set1_epi32(int32_t(uint32_t(y) << 23));
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i x = _mm_castps_si128(_mm_loadu_ps(input + i));
+            _mm_storeu_ps(output + i, _mm_castsi128_ps(_mm_add_epi32(x, exponent)));
+        }
+#elif DSP_ARM_AARCH64
+        const int32x4_t exponent = vdupq_n_s32(int32_t(uint32_t(y) << 23));
+        for (; i + 4 <= count; i += 4)
+        {
+            const int32x4_t x = vreinterpretq_s32_f32(vld1q_f32(input + i));
+            vst1q_f32(output + i, vreinterpretq_f32_s32(vaddq_s32(x, exponent)));
+        }
+#endif
+        for (; i != count; ++i) output[i] = floatScaleByPow2(input[i], y);
+    }
+
+
 }   // namespace
 
@@ -2,6 +2,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace logue {
@@ -105,6 +106,34 @@ namespace logue {
     static_assert(offsetof (MainState_210, magic1234567) == 0x9c, "Structure sanity check");
 
 
+    /** The neutral main state, used until the firmware is recognised: the filter fully open and the EG
+     *  and AMP velocities at their neutral values, with everything else zero. It is constant, so it is
+     *  never written and any number of panels can share it.
+     */
+    constexpr MainState_210 kMainStateDefaults_210 =
+    {
+        {
+            {
+                { {}, {} },                                     // vco
+                0, 0, 0, 0, 0, 0, 0, 0,                         // pitchEgModulation to filterResonanceControl
+                0x2000,                                         // filterCutoffControl
+                0, 0, 0, 0, 0, 0, 0,                            // crossModulationDepth to u5c
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,             // u60 to u6b
+            }
+        },
+        0, 0, 0, 0, 0, 0, 0,                                    // multiPitch to u76
+        0x2000,                                                 // egVelocity
+        0, 0, 0,                                                // u7a to u7e
+        0x1400,                                                 // ampVelocity
+        0, 0, 0, 0, 0, 0, 0, 0,                                 // u82 to magic1234567
+    };
+
+    static_assert(kMainStateDefaults_210.engine[0].filterCutoffControl == 0x2000, "Defaults sanity check");
+    static_assert(kMainStateDefaults_210.engine[0].crossModulationDepth == 0, "Defaults sanity check");
+    static_assert(kMainStateDefaults_210.egVelocity == 0x2000 && kMainStateDefaults_210.ampVelocity == 0x1400, "Defaults sanity check");
+    static_assert(kMainStateDefaults_210.magic1234567 == 0, "Defaults sanity check");
+
+
     /** LFO Generation. 0x20008970. Prologue.
      *
      *  The user oscillator parameter fields are:
@@ -133,9 +162,12 @@ namespace logue {
         int32_t     pitchOut;       // 0x20/32  LFO Pitch modulation (if panel set to 'pitch')          [-0x4d29, +0x4d29]
         int32_t     filterOut;      // 0x24/32  LFO Filter modulation (if panel set to 'filter')        (-0x1000, +0x1000)
         int32_t     shapeOut;       // 0x28/32  LFO Shape modulation (if panel set to 'shape')          (-0x2000, +0x2000)
-        void*       u2c;            // 0x2c/32  Pointer to struct user_osc_param. Value at offset 0x04 scales the pitch modulation value. eg 0x2000d528.
+        uint32_t    u2c;            // 0x2c/32  Pointer to struct user_osc_param. Value at offset 0x04 scales the pitch modulation value. eg 0x2000d528.
     } LfoState_Prologue_210;
 
+    static_assert(sizeof (LfoState_Prologue_210) == 0x30, "Structure sanity check");
+    static_assert(offsetof (LfoState_Prologue_210, shapeOut) == 0x28, "Structure sanity check");
+
 
 
     /** LFO Generation. 0x20008970. Minilogue.
@@ -169,16 +201,12 @@ namespace logue {
         int32_t     pitchOut;       // 0x20/32  LFO Pitch modulation (if panel set to 'pitch')          [-0x4d29, +0x4d29]
         int32_t     filterOut;      // 0x24/32  LFO Filter modulation (if panel set to 'filter')        (-0x1000, +0x1000)
         int32_t     shapeOut;       // 0x28/32  LFO Shape modulation (if panel set to 'shape')          (-0x2000, +0x2000)
-        void*       u2c;            // 0x2c/32  Pointer to struct user_osc_param. Value at offset 0x04 scales the pitch modulation value. eg 0x2000d528.
+        uint32_t    u2c;            // 0x2c/32  Pointer to struct user_osc_param. Value at offset 0x04 scales the pitch modulation value. eg 0x2000d528.
     } LfoState_Minilogue_210;
 
+    static_assert(sizeof (LfoState_Minilogue_210) == 0x30, "Structure sanity check");
+    static_assert(offsetof (LfoState_Minilogue_210, shapeOut) == 0x28, "Structure sanity check");
 
-    // Since the LFO structures are almost the same, we can just use a typedef to select the correct structure for the build.
-#if PLATFORM_KORG_PROLOGUE
-    typedef LfoState_Prologue_210 LfoState_210;
-#elif PLATFORM_KORG_MINILOGUE_XD
-    typedef LfoState_Minilogue_210 LfoState_210;
-#endif
 
 
 
@@ -249,37 +277,244 @@ namespace logue {
 
 
 
-    // Set the canonical definitions based on the platform.
+    /** Structure layouts. Each names a set of the structure types above. Firmware releases that share a
+     *  layout differ only in their addresses, so adding one is a change to the registry data below.
+     */
+    static const uint8_t kLayout210                                 =   1;      ///< MainState_210, LfoState_Prologue_210 or LfoState_Minilogue_210, EnvelopeState_210, VcoStateArray_210
+
+
+    /** One known firmware release: the flash checksum that identifies it, and where its state lives.
+     */
+    struct FirmwareLayout
+    {
+        uint32_t    flashHash;              ///< Checksum of the flash range below. See BasicPanel::validate().
+        uint16_t    flashBlocks;            ///< The checksummed range: 32 byte blocks from kFirmwareHashAddress.
+        uint16_t    version;                ///< The firmware version, BCD. eg 0x0210 for 2.10.
+        uint8_t     layout;                 ///< The structure layout, eg kLayout210.
+        uint32_t    mainAddress;            ///< MainState
+        uint32_t    lfoAddress;             ///< LfoState
+        uint32_t    envelopeAddress;        ///< EnvelopeState
+        uint32_t    vcoAddress;             ///< VcoStateArray
+    };
+
+
+    // The start of the checksummed flash ranges. The ranges all start here, so they nest, and a single
+    // pass over the longest identifies any of the releases.
+    static const uint32_t kFirmwareHashAddress                      =   0x08000000u;
+
+
+    // The known firmware releases for each platform.
+    static constexpr const FirmwareLayout kPrologueFirmwareLayouts[]       =
+    {
+        //  flashHash       blocks  version     layout          main            lfo             envelope        vco
+        {   0x0eff0f53u,    384,    0x0210,     kLayout210,     0x20009e40u,    0x20008970u,    0x200089a0u,    0x20008850u     },
+    };
+
+    static constexpr const FirmwareLayout kMinilogueXdFirmwareLayouts[]    =
+    {
+        //  flashHash       blocks  version     layout          main            lfo             envelope        vco
+        {   0x2a6b3685u,    384,    0x0210,     kLayout210,     0x20009e40u,    0x20008970u,    0x200089a0u,    0x20008850u     },
+    };
+
+
+    /** Platform policies. Each describes one synth: its structure types, how its LFO behaves and the
+     *  firmware releases it is known to run. Panel is a template on the policy (BasicPanel), so the
+     *  platform differences are resolved at compile time, and a host build can instantiate all of the
+     *  platforms side by side. The platform that a synth build targets is selected as logue::Platform.
+     */
+    struct ProloguePlatform
+    {
+        static const bool kPanelSupport                             =   true;
+        static const bool kLfoHasOneShot                            =   false;
+        static const uint32_t kTarget                               =   0x0100;     ///< k_user_target_prologue (userprg.h)
+        static const uint8_t kLayout                                =   kLayout210;
+        static constexpr const float kLfoClockHz                    =   40500.0f;
+        static const unsigned kFirmwareLayoutCount                  =   sizeof kPrologueFirmwareLayouts / sizeof kPrologueFirmwareLayouts[0];
+        static constexpr const FirmwareLayout* firmwareLayouts()    { return kPrologueFirmwareLayouts; }
+        static constexpr MainState_210 mainStateDefaults()         { return kMainStateDefaults_210; }
+        static const char* name()                                   { return "Prologue"; }
+
+        typedef VcoControl_210 VcoControl;
+        typedef Engine_210 Engine;
+        typedef MainState_210 MainState;
+        typedef LfoState_Prologue_210 LfoState;
+        typedef EnvelopeState_210 EnvelopeState;
+        typedef VcoState_210 VcoState;
+        typedef VcoStateArray_210 VcoStateArray;
+    };
+
+
+    /** The Minilogue XD adds a one-shot LFO mode (LfoState::mode and LfoState::active).
+     */
+    struct MinilogueXdPlatform
+    {
+        static const bool kPanelSupport                             =   true;
+        static const bool kLfoHasOneShot                            =   true;
+        static const uint32_t kTarget                               =   0x0200;     ///< k_user_target_miniloguexd (userprg.h)
+        static const uint8_t kLayout                                =   kLayout210;
+        static constexpr const float kLfoClockHz                    =   40500.0f;
+        static const unsigned kFirmwareLayoutCount                  =   sizeof kMinilogueXdFirmwareLayouts / sizeof kMinilogueXdFirmwareLayouts[0];
+        static constexpr const FirmwareLayout* firmwareLayouts()    { return kMinilogueXdFirmwareLayouts; }
+        static constexpr MainState_210 mainStateDefaults()         { return kMainStateDefaults_210; }
+        static const char* name()                                   { return "MinilogueXD"; }
+
+        typedef VcoControl_210 VcoControl;
+        typedef Engine_210 Engine;
+        typedef MainState_210 MainState;
+        typedef LfoState_Minilogue_210 LfoState;
+        typedef EnvelopeState_210 EnvelopeState;
+        typedef VcoState_210 VcoState;
+        typedef VcoStateArray_210 VcoStateArray;
+    };
+
+
+    /** The NTS-1 does not expose any panel state. BasicPanel provides neutral stubs.
+     */
+    struct Nts1Platform
+    {
+        static const bool kPanelSupport                             =   false;
+        static const bool kLfoHasOneShot                            =   false;
+        static const uint32_t kTarget                               =   0x0300;     ///< k_user_target_nutektdigital (userprg.h)
+        static constexpr const float kLfoClockHz                    =   0.0f;
+        static const char* name()                                   { return "NTS1"; }
+    };
+
+
+    // Select the platform for the build, and set the canonical definitions from it.
 #if PLATFORM_KORG_PROLOGUE
 #define LOGUE_INTERNALS_PANEL_SUPPORT   (1)     ///< Set logical false if the target does not (can never possibly) support panel control.
-    typedef VcoControl_210 VcoControl;
-    typedef Engine_210 Engine;
-    typedef MainState_210 MainState;
-    typedef LfoState_210 LfoState;
-    typedef EnvelopeState_210 EnvelopeState;
-    typedef VcoState_210 VcoState;
-    typedef VcoStateArray_210 VcoStateArray;
-    static constexpr const MainState* MainStateAddress              =   (const MainState*)(0x20009e40);
-    static constexpr const LfoState* LfoStateAddress                =   (const LfoState*)(0x20008970);
-    static constexpr const EnvelopeState* EnvelopeStateAddress      =   (const EnvelopeState*)(0x200089a0);
-    static constexpr const VcoStateArray* VcoStateArrayAddress      =   (const VcoStateArray*)(0x20008850);
-    static constexpr const float kLfoClockHz                        =   40500.0f;
-#elif PLATFORM_KORG_MINILOGUE_XD
+    typedef ProloguePlatform Platform;
+#elif PLATFORM_KORG_MINILOGUE_XD || PLATFORM_HOST
 #define LOGUE_INTERNALS_PANEL_SUPPORT   (1)     ///< Set logical false if the target does not (can never possibly) support panel control.
-    typedef VcoControl_210 VcoControl;
-    typedef Engine_210 Engine;
-    typedef MainState_210 MainState;
-    typedef LfoState_210 LfoState;
-    typedef EnvelopeState_210 EnvelopeState;
-    typedef VcoState_210 VcoState;
-    typedef VcoStateArray_210 VcoStateArray;
-    static constexpr const MainState* MainStateAddress              =   (const MainState*)(0x20009e40);
-    static constexpr const LfoState* LfoStateAddress                =   (const LfoState*)(0x20008970);
-    static constexpr const EnvelopeState* EnvelopeStateAddress      =   (const EnvelopeState*)(0x200089a0);
-    static constexpr const VcoStateArray* VcoStateArrayAddress      =   (const VcoStateArray*)(0x20008850);
-    static constexpr const float kLfoClockHz                        =   40500.0f;
+    typedef MinilogueXdPlatform Platform;       // On the host: the Minilogue XD layout is a superset of the Prologue's.
 #else
 #define LOGUE_INTERNALS_PANEL_SUPPORT   (0)     ///< Set logical false if the target does not (can never possibly) support panel control.
+    typedef Nts1Platform Platform;
 #endif
 
+#if LOGUE_INTERNALS_PANEL_SUPPORT
+    typedef Platform::VcoControl VcoControl;
+    typedef Platform::Engine Engine;
+    typedef Platform::MainState MainState;
+    typedef Platform::LfoState LfoState;
+    typedef Platform::EnvelopeState EnvelopeState;
+    typedef Platform::VcoState VcoState;
+    typedef Platform::VcoStateArray VcoStateArray;
+    static const uint8_t kLayout                                    =   Platform::kLayout;
+#endif
+    static constexpr const float kLfoClockHz                        =   Platform::kLfoClockHz;
+
+
+
+#if PLATFORM_HOST
+
+    /** Host builds have no firmware to identify. Instead, a host tool provides the state structures (eg
+     *  from a panel emulator or a trace) and attaches them to each panel with BasicPanel::attach().
+     *  The structures must outlive the rendering.
+     */
+    template <typename Platform> struct BasicHostPanelMemory
+    {
+        const typename Platform::MainState*         main;
+        const typename Platform::LfoState*          lfo;
+        const typename Platform::EnvelopeState*     envelope;
+        const typename Platform::VcoStateArray*     vco;
+    };
+
+    typedef BasicHostPanelMemory<Platform> HostPanelMemory;        ///< The structures for the build's platform.
+
+#endif
+
+
+
+    /** Lookup of a platform's firmware releases by flash checksum.
+     *
+     *  The checksum runs once over the longest range, hashBlocks(). The end of each release's range is
+     *  a checkpoint, where the running checksum is looked up. The checksums are spread over a slot
+     *  table that is built by the compiler, so each lookup is a single probe whatever the number of
+     *  releases. A static_assert fails if two releases share a slot, in which case kSlots should be
+     *  increased.
+     */
+    template <typename Platform> class FirmwareRegistry
+    {
+    public:
+
+        /** Find a release.
+         *
+         *  @param  flashHash   The flash checksum.
+         *  @param  flashBlocks The length of the checksummed range, in blocks.
+         *  @return             The release, or nullptr if it is not known.
+         */
+        static const FirmwareLayout* find(uint32_t flashHash, unsigned flashBlocks) { return find(flashHash, flashBlocks, typename MakeIndices<kSlots>::Type()); }
+
+
+        /** Return the length of the longest range, in blocks: the end of the checksum pass.
+         */
+        static constexpr unsigned hashBlocks(unsigned index = 0)
+        {
+            return (index == kCount) ? 0 : max(Platform::firmwareLayouts()[index].flashBlocks, hashBlocks(index + 1));
+        }
+
+
+        /** Return the next checkpoint: the first range end after @e blocks, or hashBlocks() if none.
+         *
+         *  @param  blocks      The length checksummed so far, [0, hashBlocks()).
+         */
+        static unsigned nextCheckpoint(unsigned blocks)
+        {
+            unsigned checkpoint = hashBlocks();
+            for (unsigned index = 0; index != kCount; ++index)
+            {
+                const unsigned end = Platform::firmwareLayouts()[index].flashBlocks;
+                if (end > blocks && end < checkpoint) checkpoint = end;
+            }
+            return checkpoint;
+        }
+
+
+    private:
+
+        static const unsigned kSlots = 8;
+        static const unsigned kCount = Platform::kFirmwareLayoutCount;
+
+        static_assert((kSlots & (kSlots - 1)) == 0 && kSlots <= 256, "kSlots must be a power of two, up to 256");
+
+        static constexpr unsigned max(unsigned a, unsigned b) { return (a > b) ? a : b; }
+        static constexpr unsigned slot(uint32_t flashHash) { return (flashHash ^ (flashHash >> 8) ^ (flashHash >> 16) ^ (flashHash >> 24)) & (kSlots - 1); }
+
+        // The index plus one of the release that uses a slot, or zero if none.
+        static constexpr uint8_t slotEntry(unsigned slotIndex, unsigned index = 0)
+        {
+            return (index == kCount) ? 0 : (slot(Platform::firmwareLayouts()[index].flashHash) == slotIndex) ? uint8_t(index + 1) : slotEntry(slotIndex, index + 1);
+        }
+
+        static constexpr unsigned slotUsers(unsigned slotIndex, unsigned index = 0)
+        {
+            return (index == kCount) ? 0 : unsigned(slot(Platform::firmwareLayouts()[index].flashHash) == slotIndex) + slotUsers(slotIndex, index + 1);
+        }
+
+        static constexpr bool slotsAreUnique(unsigned slotIndex = 0)
+        {
+            return (slotIndex == kSlots) || ((slotUsers(slotIndex) <= 1) && slotsAreUnique(slotIndex + 1));
+        }
+
+        // Compile time generation of the slot table, { slotEntry(0), ..., slotEntry(kSlots - 1) }.
+        template <unsigned... I> struct Indices {};
+        template <unsigned N, unsigned... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+        template <unsigned... I> struct MakeIndices<0, I...> { typedef Indices<I...> Type; };
+
+        template <unsigned... I> static const FirmwareLayout* find(uint32_t flashHash, unsigned flashBlocks, Indices<I...>);
+    };
+
+    // Defined outside the class, as the slot table can only be built once the class is complete.
+    template <typename Platform> template <unsigned... I> inline const FirmwareLayout* FirmwareRegistry<Platform>::find(uint32_t flashHash, unsigned flashBlocks, Indices<I...>)
+    {
+        static constexpr uint8_t slots[kSlots] = { slotEntry(I)... };
+        static_assert(slotsAreUnique(), "two firmware releases share a registry slot: increase kSlots");
+
+        const unsigned index = slots[slot(flashHash)];
+        if (index == 0) return nullptr;
+        const FirmwareLayout* layout = &Platform::firmwareLayouts()[index - 1];
+        return (layout->flashHash == flashHash && layout->flashBlocks == flashBlocks) ? layout : nullptr;
+    }
+
 }   // namespace
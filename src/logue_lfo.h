@@ -0,0 +1,240 @@
+/** LFO waveform generation for Logue.
+ *
+ *  Waveforms are evaluated from a UQ32 phase (as PanelSnapshot::lfoPhase or LfoReader::tick()) in
+ *  fixed point, without branches. The firmware shapes keep their firmware numbering, so the panel
+ *  LFO waveform can be passed straight to setWaveform():
+ *
+ *      Waveform        Shape
+ *      kSquare         +1 for the first half cycle, -1 for the second
+ *      kTriangle       -1 at phase 0, +1 at phase 0.5
+ *      kSaw            Falling, +1 to -1
+ *      kSine           sin(2 * pi * phase), to ~1e-3 (parabola with a second-order correction)
+ *      kExpDown        Exponential fall over 8 octaves (48 dB), +1 to ~-1
+ *      kExpUp          kExpDown reversed in time
+ *      kSampleHold     A new random level at the start of each cycle
+ *      kSmoothRandom   Random levels joined by a smoothstep curve, continuous at the cycle start
+ *
+ *  The random shapes are derived by hashing a per-instance seed with a cycle count, so two LFOs
+ *  with the same seed produce the same sequence. Seed from logue::VoiceID to decorrelate voices.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+#include "logue_panel.h"
+
+namespace logue
+{
+    class Lfo
+    {
+    public:
+
+        static const unsigned kSquare       = 0;
+        static const unsigned kTriangle     = 1;
+        static const unsigned kSaw          = 2;
+        static const unsigned kSine         = 3;
+        static const unsigned kExpDown      = 4;
+        static const unsigned kExpUp        = 5;
+        static const unsigned kSampleHold   = 6;
+        static const unsigned kSmoothRandom = 7;
+        static const unsigned kWaveforms    = 8;        ///< The number of waveforms. Any other index renders zero.
+
+
+        /** Constructor.
+         *
+         *  @param  seed        The seed for the random waveforms.
+         */
+        explicit Lfo(uint32_t seed = 0) { reset(seed); }
+
+
+        /** Restart the random sequence.
+         *
+         *  @param  seed        The seed for the random waveforms.
+         */
+        void reset(uint32_t seed)
+        {
+            m_state.seed = seed;
+            m_state.cycle = 0;
+            m_state.lastPhase = 0;
+        }
+
+
+        /** Select the waveform.
+         *
+         *  @param  waveform    One of kSquare to kSmoothRandom. Other values select silence.
+         */
+        void setWaveform(unsigned waveform)
+        {
+            m_waveform = (waveform < kWaveforms) ? waveform : kWaveforms;
+        }
+
+
+        /** Fill a modulation buffer. The waveform is selected once per block through a table.
+         *
+         *  @param  phase       The phase source, started for this block.
+         *  @param  output      Receives the modulation, [-gain, gain].
+         *  @param  frames      The number of samples to generate.
+         *  @param  gain        The output scale.
+         */
+        void render(LfoReader& phase, float* output, unsigned frames, float gain)
+        {
+            typedef void (Lfo::*Render)(LfoReader&, float*, unsigned, float);
+            static const Render kRender[kWaveforms + 1] =
+            {
+                &Lfo::renderWave<Square>,
+                &Lfo::renderWave<Triangle>,
+                &Lfo::renderWave<Saw>,
+                &Lfo::renderWave<Sine>,
+                &Lfo::renderWave<ExpDown>,
+                &Lfo::renderWave<ExpUp>,
+                &Lfo::renderWave<SampleHold>,
+                &Lfo::renderWave<SmoothRandom>,
+                &Lfo::renderWave<Zero>,
+            };
+            (this->*kRender[m_waveform])(phase, output, frames, gain);
+        }
+
+
+        // The stateless shapes, Q31, for per-sample use with a fixed waveform.
+        static DSP_INLINE int32_t square(uint32_t phase) { return int32_t(0x7fffffffu ^ (uint32_t(int32_t(phase) >> 31) & 0xfffffffeu)); }
+        static DSP_INLINE int32_t triangle(uint32_t phase) { return int32_t(uint32_t((int32_t(phase) ^ (int32_t(phase) >> 31)) - 0x40000000) << 1); }
+        static DSP_INLINE int32_t saw(uint32_t phase) { return int32_t(0x7fffffffu - phase); }
+
+        static DSP_INLINE int32_t sine(uint32_t phase)
+        {
+            // sin(2 * pi * phase) = sin(pi * x), x = phase as Q31 in [-1.0, 1.0). The parabola 4x(1 - |x|)
+            // is exact at the zeros and peaks, and y + 0.225(y|y| - y) corrects it to a ~1e-3 error.
+            const int32_t x = int32_t(phase);
+            const int32_t y = int32_t((int64_t(x) * (0x7fffffff - (x ^ (x >> 31)))) >> 29);
+            const int32_t yy = int32_t((int64_t(y) * (y ^ (y >> 31))) >> 31);
+            return y + int32_t((int64_t(yy - y) * 483183821) >> 31);
+        }
+
+        static DSP_INLINE int32_t expDown(uint32_t phase)
+        {
+            // 2^(-8 * phase): the top 3 bits are the octave shift, the next 4 index a table of
+            // 2^(-i/16) and the next 16 interpolate. The result is mapped from (2^-8, 1.0] to (-1.0, 1.0].
+            static const int32_t table[17] =
+            {
+                0x7fffffff, 0x7a92be8b, 0x75606374, 0x70666f76, 0x6ba27e65, 0x6712460b, 0x62b39509, 0x5e8451d0,
+                0x5a82799a, 0x56ac1f75, 0x52ff6b55, 0x4f7a9930, 0x4c1bf829, 0x48e1e9ba, 0x45cae0f2, 0x42d561b4,
+                0x40000000,
+            };
+            const int32_t* entry = &table[(phase >> 25) & 15u];
+            const int32_t fraction = int32_t((phase >> 9) & 0xffffu);
+            const int32_t value = entry[0] + int32_t((int64_t(entry[1] - entry[0]) * fraction) >> 16);
+            return int32_t((uint32_t(value >> (phase >> 29)) << 1) - 0x7fffffffu);
+        }
+
+        static DSP_INLINE int32_t expUp(uint32_t phase) { return expDown(~phase); }
+
+
+        /** The firmware LFO shapes, kSquare, kTriangle and kSaw (as PanelSnapshot::lfoWaveform), for
+         *  per-sample use inside another render loop. The waveform is chosen once, and each sample
+         *  selects between the three shapes with masks rather than a branch or a call, so that a single
+         *  loop serves all three. Any other waveform gives the square.
+         */
+        class FirmwareShape
+        {
+        public:
+
+            explicit FirmwareShape(unsigned waveform)
+                : m_triangle(-int32_t(waveform == kTriangle)), m_saw(-int32_t(waveform == kSaw)) {}
+
+            DSP_INLINE int32_t sample(uint32_t phase) const
+            {
+                return (square(phase) & ~(m_triangle | m_saw)) | (triangle(phase) & m_triangle) | (saw(phase) & m_saw);
+            }
+
+        private:
+
+            int32_t     m_triangle;         // All ones to select the triangle, else zero
+            int32_t     m_saw;              // All ones to select the saw, else zero
+        };
+
+
+    private:
+
+        struct State
+        {
+            uint32_t    seed;
+            uint32_t    cycle;              // Count of phase wraps
+            uint32_t    lastPhase;
+        };
+
+
+        /** Count a phase wrap. A backward step of less than kJitter is the block to block error in
+         *  LfoReader's extrapolation, not a new cycle; a larger one is a wrap or an LFO retrigger.
+         */
+        static DSP_INLINE uint32_t cycle(State& state, uint32_t phase)
+        {
+            static const uint32_t kJitter = 1u << 24;
+            state.cycle += uint32_t(phase < state.lastPhase) & uint32_t((state.lastPhase - phase) > kJitter);
+            state.lastPhase = phase;
+            return state.seed + state.cycle;
+        }
+
+        static DSP_INLINE int32_t random(uint32_t n)
+        {
+            // Integer hash with good avalanche (lowbias32).
+            n ^= n >> 16;
+            n *= 0x7feb352du;
+            n ^= n >> 15;
+            n *= 0x846ca68bu;
+            n ^= n >> 16;
+            return int32_t(n);
+        }
+
+
+        // Waveform kernels for renderWave().
+        struct Square { static DSP_INLINE int32_t sample(uint32_t phase, State&) { return square(phase); } };
+        struct Triangle { static DSP_INLINE int32_t sample(uint32_t phase, State&) { return triangle(phase); } };
+        struct Saw { static DSP_INLINE int32_t sample(uint32_t phase, State&) { return saw(phase); } };
+        struct Sine { static DSP_INLINE int32_t sample(uint32_t phase, State&) { return sine(phase); } };
+        struct ExpDown { static DSP_INLINE int32_t sample(uint32_t phase, State&) { return expDown(phase); } };
+        struct ExpUp { static DSP_INLINE int32_t sample(uint32_t phase, State&) { return expUp(phase); } };
+        struct Zero { static DSP_INLINE int32_t sample(uint32_t, State&) { return 0; } };
+
+        struct SampleHold
+        {
+            static DSP_INLINE int32_t sample(uint32_t phase, State& state) { return random(cycle(state, phase)); }
+        };
+
+        struct SmoothRandom
+        {
+            static DSP_INLINE int32_t sample(uint32_t phase, State& state)
+            {
+                // Smoothstep, 3t^2 - 2t^3, from this cycle's level to the next.
+                const uint32_t n = cycle(state, phase);
+                const int32_t y0 = random(n);
+                const int32_t y1 = random(n + 1);
+                const uint32_t t = phase >> 1;                                              // UQ1.31
+                const uint32_t t2 = uint32_t((uint64_t(t) * t) >> 31);                      // UQ1.31
+                const uint32_t s = uint32_t((uint64_t(t2) * ((3u << 30) - t)) >> 30);       // UQ1.31, (3 - 2t) as UQ2.30
+                return y0 + int32_t(((int64_t(y1) - y0) * s) >> 31);
+            }
+        };
+
+
+        template <typename Wave> void renderWave(LfoReader& phase, float* output, unsigned frames, float gain)
+        {
+            const float scale = gain * (1.0f / 2147483648.0f);
+            auto reader = phase;
+            auto state = m_state;
+
+            for (unsigned i = 0; i != frames; ++i)
+            {
+                output[i] = float(Wave::sample(reader.tick(), state)) * scale;
+            }
+
+            m_state = state;
+            phase = reader;
+        }
+
+
+    private:
+
+        State       m_state;
+        unsigned    m_waveform      { kSquare };
+    };
+
+}   // namespace
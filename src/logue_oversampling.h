@@ -0,0 +1,269 @@
+/** Oversampling for Logue: polyphase half-band FIR decimators.
+ *
+ *  A process that generates harmonics above the Nyquist frequency (eg phase modulation) can run at
+ *  2x or 4x the output rate and be filtered back down, so that those harmonics are removed rather
+ *  than aliased. Each halving of the rate is a half-band FIR: every other tap of a half-band filter
+ *  is zero apart from the centre one, and only every other output is needed, so in polyphase form
+ *  each output costs one multiply per symmetric pair of taps. The centre tap branch is a delay.
+ *
+ *  The kernels are minimax (equiripple) designs with the passband flat to 20 kHz at the 48 kHz
+ *  output. A half-band response is symmetric about a quarter of the input rate, so the ripple in the
+ *  passband equals the attenuation of the stopband, which starts at 28 kHz: anything between 24 and
+ *  28 kHz aliases to between 20 and 24 kHz, above the passband.
+ *
+ *      Kernel              Taps    Multiplies  Stopband        Use
+ *      HalfbandKernel7     7       3           46 dB           4x first stage (192 to 96 kHz)
+ *      HalfbandKernel11    11      4           66 dB           4x first stage (192 to 96 kHz)
+ *      HalfbandKernel23    23      7           39 dB           96 to 48 kHz
+ *      HalfbandKernel31    31      9           49 dB           96 to 48 kHz
+ *      HalfbandKernel47    47      13          69 dB           96 to 48 kHz
+ *
+ *  The 4x first stage only has to protect what the second stage passes, so a few taps are enough.
+ *  Its stopband in the table starts at 76 kHz, which folds to 20 kHz at 96 kHz: everything that would
+ *  alias into the passband is attenuated by the full amount. Between 68 and 76 kHz the attenuation
+ *  falls to 23.7 dB (HalfbandKernel7) and 30.6 dB (HalfbandKernel11) at 68 kHz, but that band folds to
+ *  20 to 28 kHz, above the passband, and reaches the output only between 20 and 24 kHz.
+ *  OversamplingQuality groups the kernels into three grades, and
+ *  Oversampler<Factor, Quality> is the decimation chain for a factor of 1 (none), 2 or 4.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+
+namespace logue
+{
+    // Half-band kernels. kPairs is the number of symmetric pairs of non-zero odd taps, so the length is
+    // 4 * kPairs - 1, and coefficient(j) is the tap at offsets +/-(2j + 1) from the centre.
+
+    struct HalfbandKernel7
+    {
+        static const unsigned kPairs = 2;
+        static DSP_INLINE float coefficient(unsigned j)
+        {
+            static const float k[kPairs] = { 2.909928648e-01f, -4.349266752e-02f };
+            return k[j];
+        }
+    };
+
+    struct HalfbandKernel11
+    {
+        static const unsigned kPairs = 3;
+        static DSP_INLINE float coefficient(unsigned j)
+        {
+            static const float k[kPairs] = { 2.990573759e-01f, -5.896815485e-02f, 1.015094131e-02f };
+            return k[j];
+        }
+    };
+
+    struct HalfbandKernel23
+    {
+        static const unsigned kPairs = 6;
+        static DSP_INLINE float coefficient(unsigned j)
+        {
+            static const float k[kPairs] =
+            {
+                3.156878139e-01f, -9.842405325e-02f, 5.146755483e-02f, -2.959189814e-02f, 1.682351588e-02f, -1.149866716e-02f
+            };
+            return k[j];
+        }
+    };
+
+    struct HalfbandKernel31
+    {
+        static const unsigned kPairs = 8;
+        static DSP_INLINE float coefficient(unsigned j)
+        {
+            static const float k[kPairs] =
+            {
+                3.161955110e-01f, -9.989077639e-02f, 5.372980342e-02f, -3.240507183e-02f,
+                1.989300638e-02f, -1.185324472e-02f, 6.583679303e-03f, -3.939948194e-03f
+            };
+            return k[j];
+        }
+    };
+
+    struct HalfbandKernel47
+    {
+        static const unsigned kPairs = 12;
+        static DSP_INLINE float coefficient(unsigned j)
+        {
+            static const float k[kPairs] =
+            {
+                3.167996395e-01f, -1.016449246e-01f, 5.646611987e-02f, -3.586940568e-02f,
+                2.377711707e-02f, -1.583466513e-02f, 1.036322089e-02f, -6.552288418e-03f,
+                3.933339301e-03f, -2.191830673e-03f, 1.093110185e-03f, -5.076645738e-04f
+            };
+            return k[j];
+        }
+    };
+
+
+    /** The sum of the odd taps of a half-band kernel from pair First to pair First + Count - 1, where
+     *  newest[-n] is the odd branch sample n pairs ago.
+     *
+     *  The sum is expanded at compile time and split in halves, so it is fully unrolled at any
+     *  optimisation level (the synth builds use -Os) and the adds form a tree rather than one chain.
+     */
+    template <typename Kernel, unsigned First, unsigned Count> struct HalfbandTaps
+    {
+        static DSP_INLINE float sum(const float* newest)
+        {
+            return HalfbandTaps<Kernel, First, Count / 2>::sum(newest) + HalfbandTaps<Kernel, First + Count / 2, Count - Count / 2>::sum(newest);
+        }
+    };
+
+    template <typename Kernel, unsigned First> struct HalfbandTaps<Kernel, First, 1>
+    {
+        static DSP_INLINE float sum(const float* newest)
+        {
+            return Kernel::coefficient(First) * (newest[-int(Kernel::kPairs - 1 - First)] + newest[-int(Kernel::kPairs + First)]);
+        }
+    };
+
+
+    /** Decimation by 2 with a half-band kernel.
+     *
+     *  The input arrives as pairs: x0, the earlier sample, feeds the centre tap, and x1 feeds the odd
+     *  taps. Both histories are circular buffers of 2 * kPairs pairs with each sample written twice,
+     *  kLength apart, so that the most recent kLength samples are always contiguous and the taps are
+     *  read without wrapping. The state is a fixed 16 * kPairs bytes per branch.
+     *
+     *  @tparam Kernel      One of the HalfbandKernel types.
+     */
+    template <typename Kernel> class HalfbandDecimator
+    {
+    public:
+
+        static const unsigned kPairs = Kernel::kPairs;
+        static const unsigned kDelay = 2 * kPairs - 1;          ///< The group delay, in input samples.
+
+
+        void reset()
+        {
+            for (unsigned i = 0; i != 2 * kLength; ++i)
+            {
+                m_even[i] = 0.0f;
+                m_odd[i] = 0.0f;
+            }
+            m_position = 0;
+        }
+
+
+        /** Filter a pair of input samples and return one output sample.
+         *
+         *  @param  x0          The earlier input sample.
+         *  @param  x1          The later input sample.
+         *  @return             The output sample.
+         */
+        DSP_INLINE float process(float x0, float x1)
+        {
+            const unsigned position = m_position;
+            m_even[position] = m_even[position + kLength] = x0;
+            m_odd[position] = m_odd[position + kLength] = x1;
+
+            // newest[-n] is the sample n pairs ago. The centre tap lies between odd samples kPairs - 1
+            // and kPairs ago, and the pairs of odd taps spread out from there.
+            const float* newest = &m_odd[position + kLength];
+            const float y = 0.5f * m_even[position + kLength - (kPairs - 1)] + HalfbandTaps<Kernel, 0, kPairs>::sum(newest);
+
+            m_position = (position + 1 == kLength) ? 0 : position + 1;
+            return y;
+        }
+
+
+    private:
+
+        static const unsigned kLength = 2 * kPairs;
+
+        float       m_even[2 * kLength]     {};
+        float       m_odd[2 * kLength]      {};
+        unsigned    m_position              { 0 };
+    };
+
+
+    /** The kernels for each grade of oversampling quality, [0, 2]: Kernel for the final 96 to 48 kHz
+     *  stage and Kernel4x for the first stage at 4x. The cost per output sample is set by the grade,
+     *  and does not depend on the signal.
+     */
+    template <unsigned Quality> struct OversamplingQuality;
+
+    template <> struct OversamplingQuality<0>
+    {
+        typedef HalfbandKernel23    Kernel;
+        typedef HalfbandKernel7     Kernel4x;
+    };
+
+    template <> struct OversamplingQuality<1>
+    {
+        typedef HalfbandKernel31    Kernel;
+        typedef HalfbandKernel11    Kernel4x;
+    };
+
+    template <> struct OversamplingQuality<2>
+    {
+        typedef HalfbandKernel47    Kernel;
+        typedef HalfbandKernel11    Kernel4x;
+    };
+
+
+    /** The decimation chain for an oversampling factor.
+     *
+     *  process() takes kFactor consecutive input samples, oldest first, and returns one output sample.
+     *  With a factor of 1 it returns the input, so a render loop can be a template on the oversampler
+     *  and compile to the plain loop when oversampling is off.
+     *
+     *  @tparam Factor      The oversampling factor: 1, 2 or 4.
+     *  @tparam Quality     The filter grade, see OversamplingQuality.
+     */
+    template <unsigned Factor, unsigned Quality = 1> class Oversampler;
+
+    template <unsigned Quality> class Oversampler<1, Quality>
+    {
+    public:
+
+        static const unsigned kFactor = 1;
+
+        void reset() {}
+        DSP_INLINE float process(const float* xn) { return xn[0]; }
+    };
+
+    template <unsigned Quality> class Oversampler<2, Quality>
+    {
+    public:
+
+        static const unsigned kFactor = 2;
+
+        void reset() { m_stage.reset(); }
+        DSP_INLINE float process(const float* xn) { return m_stage.process(xn[0], xn[1]); }
+
+    private:
+
+        HalfbandDecimator<typename OversamplingQuality<Quality>::Kernel>    m_stage;
+    };
+
+    template <unsigned Quality> class Oversampler<4, Quality>
+    {
+    public:
+
+        static const unsigned kFactor = 4;
+
+        void reset()
+        {
+            m_stage0.reset();
+            m_stage1.reset();
+        }
+
+        DSP_INLINE float process(const float* xn)
+        {
+            const float x0 = m_stage0.process(xn[0], xn[1]);
+            const float x1 = m_stage0.process(xn[2], xn[3]);
+            return m_stage1.process(x0, x1);
+        }
+
+    private:
+
+        HalfbandDecimator<typename OversamplingQuality<Quality>::Kernel4x>  m_stage0;
+        HalfbandDecimator<typename OversamplingQuality<Quality>::Kernel>    m_stage1;
+    };
+
+}   // namespace
@@ -7,15 +7,259 @@
 
 namespace logue
 {
-#if LOGUE_INTERNALS_PANEL_SUPPORT
+    /** The panel values used by the render path, captured together once per block.
+     *
+     *  The fields are packed so that the whole snapshot is a few words of local state. The LFO values
+     *  are guaranteed to come from the same LFO interrupt period (see Panel::capture()).
+     */
+    struct PanelSnapshot
+    {
+        int32_t     vcoPitch[2];        ///< VCO pitch, excluding modulation: 256 steps per cent.
+        uint16_t    vcoShape[2];        ///< VCO shape: [0, 0x2000]
+        uint8_t     vcoWaveform[2];     ///< VCO waveform: { 0=square, 1=triangle, 2=saw }
+        uint8_t     lfoWaveform;        ///< LFO waveform: { square=0, triangle=1, saw=2 }
+        bool        lfoIsOneShot;       ///< True if the LFO is in one-shot mode.
+        bool        lfoIsActive;        ///< False once a one-shot LFO has completed its half-cycle.
+        uint32_t    lfoPhase;           ///< LFO phase, as returned by Panel::lfoPhase().
+        uint32_t    lfoPhaseDelta;      ///< LFO phase delta per LFO clock tick.
+    };
+
+
+
+    /** Change tracking for PanelSnapshot. Each call to update() compares the new snapshot against the
+     *  previous one and returns a dirty bit per field, so that derived values only need to be
+     *  recomputed when their inputs have moved. Everything is reported dirty after construction or
+     *  reset().
+     */
+    class PanelTracker
+    {
+    public:
+
+        static const uint32_t kVcoPitch0        = 1u << 0;
+        static const uint32_t kVcoPitch1        = 1u << 1;
+        static const uint32_t kVcoShape0        = 1u << 2;
+        static const uint32_t kVcoShape1        = 1u << 3;
+        static const uint32_t kVcoWaveform0     = 1u << 4;
+        static const uint32_t kVcoWaveform1     = 1u << 5;
+        static const uint32_t kLfoWaveform      = 1u << 6;
+        static const uint32_t kLfoMode          = 1u << 7;      ///< lfoIsOneShot or lfoIsActive
+        static const uint32_t kLfoPhase         = 1u << 8;
+        static const uint32_t kLfoPhaseDelta    = 1u << 9;
+        static const uint32_t kAll              = (1u << 10) - 1;
+
+        void reset() { m_valid = false; }       ///< Mark all fields dirty on the next update.
+
+        /** Record a new snapshot.
+         *
+         *  @param  snapshot    The values for the current block.
+         *  @return             The set of fields that differ from the previous snapshot.
+         */
+        DSP_INLINE uint32_t update(const PanelSnapshot& snapshot)
+        {
+            uint32_t dirty = kAll;
+            if (m_valid)
+            {
+                dirty = 0;
+                if (snapshot.vcoPitch[0] != m_last.vcoPitch[0]) dirty |= kVcoPitch0;
+                if (snapshot.vcoPitch[1] != m_last.vcoPitch[1]) dirty |= kVcoPitch1;
+                if (snapshot.vcoShape[0] != m_last.vcoShape[0]) dirty |= kVcoShape0;
+                if (snapshot.vcoShape[1] != m_last.vcoShape[1]) dirty |= kVcoShape1;
+                if (snapshot.vcoWaveform[0] != m_last.vcoWaveform[0]) dirty |= kVcoWaveform0;
+                if (snapshot.vcoWaveform[1] != m_last.vcoWaveform[1]) dirty |= kVcoWaveform1;
+                if (snapshot.lfoWaveform != m_last.lfoWaveform) dirty |= kLfoWaveform;
+                if (snapshot.lfoIsOneShot != m_last.lfoIsOneShot || snapshot.lfoIsActive != m_last.lfoIsActive) dirty |= kLfoMode;
+                if (snapshot.lfoPhase != m_last.lfoPhase) dirty |= kLfoPhase;
+                if (snapshot.lfoPhaseDelta != m_last.lfoPhaseDelta) dirty |= kLfoPhaseDelta;
+            }
+            m_last = snapshot;
+            m_valid = true;
+            return dirty;
+        }
+
+    private:
+
+        PanelSnapshot   m_last      {};
+        bool            m_valid     { false };
+    };
+
+
+
+    /** Per-sample LFO phase for a block, extrapolated from a single PanelSnapshot.
+     *
+     *  The snapshot gives the LFO phase at the start of the block and its phase delta per LFO clock
+     *  tick. The delta is rescaled from the LFO clock to the audio rate once per block, after which
+     *  each sample costs one add. A Minilogue one-shot LFO holds at the end of its half-cycle
+     *  (0x7fffffff, as Panel::lfoPhase()), and an inactive LFO holds its phase for the whole block.
+     *
+     *  Each block restarts from the snapshot phase, so extrapolation error does not accumulate.
+     */
+    class LfoReader
+    {
+    public:
+
+        static constexpr float kSampleRateHz = 48000.0f;    ///< The audio sample rate.
+
+        /** Set the LFO clock rate. Call before the first begin().
+         *
+         *  @param  lfoClockHz  The LFO clock, from Panel::lfoClock(). Must be less than kSampleRateHz.
+         */
+        void setClock(float lfoClockHz)
+        {
+            DSP_ASSERT(lfoClockHz >= 0.0f && lfoClockHz < kSampleRateHz);
+            m_scale = floatToU32<32>(lfoClockHz * (1.0f / kSampleRateHz));
+        }
+
+        /** Start a block.
+         *
+         *  @param  snapshot    The panel values for the block.
+         */
+        DSP_INLINE void begin(const PanelSnapshot& snapshot)
+        {
+            m_phase = snapshot.lfoPhase;
+            m_phaseDelta = snapshot.lfoIsActive ? uint32_t((uint64_t(snapshot.lfoPhaseDelta) * m_scale) >> 32) : 0;
+            m_phaseLimit = snapshot.lfoIsOneShot ? 0x7fffffffu : 0xffffffffu;
+        }
+
+        /** Return the LFO phase for this sample and advance to the next.
+         *
+         *  @return             The LFO phase, UQ32, in the same form as PanelSnapshot::lfoPhase.
+         */
+        DSP_INLINE uint32_t tick()
+        {
+            const uint32_t phase = m_phase;
+            m_phase = phase + m_phaseDelta;
+            return (phase < m_phaseLimit) ? phase : m_phaseLimit;
+        }
+
+        uint32_t phaseDelta() const { return m_phaseDelta; }    ///< The phase delta per sample, UQ32.
+
+    private:
+
+        uint32_t    m_scale         { 0 };              // LFO clock / sample rate, UQ0.32
+        uint32_t    m_phase         { 0 };
+        uint32_t    m_phaseDelta    { 0 };              // Per sample
+        uint32_t    m_phaseLimit    { 0xffffffffu };    // Hold point for a one-shot LFO
+    };
+
+
+
+    /** When Panel checks the firmware. Until the check completes the panel reads neutral default values.
+     */
+    enum class PanelValidation
+    {
+        Immediate,      ///< Checksum the firmware in the constructor (~0.11 ms).
+        Deferred,       ///< Start on the defaults, and checksum the firmware a few blocks per call to Panel::validate().
+    };
+
+
+
+    /** Access to the LFO fields that only some platforms have. The LFO state is written by the LFO
+     *  interrupt, so the fields are read through volatile.
+     */
+    template <typename LfoState, bool HasOneShot> struct PanelLfoMode
+    {
+        static DSP_INLINE bool isActive(const LfoState& lfo)    { (void)lfo; return true; }
+        static DSP_INLINE bool isOneShot(const LfoState& lfo)   { (void)lfo; return false; }
+    };
+
+    template <typename LfoState> struct PanelLfoMode<LfoState, true>
+    {
+        static DSP_INLINE bool isActive(const LfoState& lfo)    { return bool(*static_cast<const volatile uint8_t*>(&lfo.active)); }
+        static DSP_INLINE bool isOneShot(const LfoState& lfo)   { return bool(*static_cast<const volatile uint8_t*>(&lfo.mode) & 1); }
+    };
+
+
 
     /** Class used to read the current state of the Logues panel controls and modulation parameters.
+     *
+     *  The platform is a policy from logue_internals.h (eg MinilogueXdPlatform), and logue::Panel is the
+     *  panel for the build's platform. Platforms without panel support get neutral stubs.
      */
-    class Panel
+    template <typename Platform, bool = Platform::kPanelSupport> class BasicPanel
     {
     public:
 
-        Panel() { init(); }         ///< Constructor.
+        typedef typename Platform::MainState        MainState;
+        typedef typename Platform::LfoState         LfoState;
+        typedef typename Platform::EnvelopeState    EnvelopeState;
+        typedef typename Platform::VcoStateArray    VcoStateArray;
+
+        /** Constructor.
+         *
+         *  @param  validation  When to check the firmware. With Deferred, call validate() once per block.
+         */
+        explicit BasicPanel(PanelValidation validation = PanelValidation::Immediate)
+        {
+            useDefaults();
+            if (validation == PanelValidation::Immediate)
+            {
+                while (isValidating()) validate(Registry::hashBlocks());
+            }
+        }
+
+
+        /** Continue a deferred firmware check, if one is in progress. Once the checksum is complete and the
+         *  firmware is recognised, the panel switches from the defaults to the live values. After that this
+         *  costs a single compare.
+         *
+         *  @param  blocks      The maximum number of 32 byte flash blocks to checksum, at ~26 cycles each.
+         */
+        DSP_INLINE void validate(unsigned blocks = kValidateBlocks)
+        {
+            if (m_hashBlocks != 0) hashFirmware(blocks);
+        }
+
+
+        DSP_INLINE bool isValidating() const { return m_hashBlocks != 0; }     ///< True until the firmware check completes (on the host, only after hashImage()).
+
+
+        /** Read the panel state from the given structures, rather than from the firmware. This ends any
+         *  firmware check in progress. Intended for host tools (emulation, replay of captured memory):
+         *  each panel is attached separately, and attaching again is cheap, so a replay can move the
+         *  panel to the next dump on every block. The structures must outlive the attachment.
+         */
+        void attach(const MainState* main, const LfoState* lfo, const EnvelopeState* envelope, const VcoStateArray* vco)
+        {
+            m_main      =   main;
+            m_lfo       =   lfo;
+            m_envelope  =   envelope;
+            m_vco       =   vco;
+            m_hashBlocks = 0;
+        }
+
+#if PLATFORM_HOST
+        void attach(const BasicHostPanelMemory<Platform>& memory) { attach(memory.main, memory.lfo, memory.envelope, memory.vco); }
+
+
+        /** Start a firmware check over an image of the flash, as validate() does on the synth, to test the
+         *  identification on the host. The image holds FirmwareRegistry<Platform>::hashBlocks() blocks of 32 bytes, and must
+         *  outlive the check. A recognised release is reported by firmware(), but the panel stays on the
+         *  defaults, since the release's addresses are the synth's.
+         */
+        void hashImage(const uint32_t* flash)
+        {
+            useDefaults();
+            m_firmware = nullptr;
+            m_hashAddress = flash;
+            m_hashBlocks = Registry::hashBlocks();
+            m_hash = kHashSeed;
+        }
+#endif
+
+
+        /** Return the firmware release that the panel recognised, or nullptr if none (yet).
+         */
+        const FirmwareLayout* firmware() const { return m_firmware; }
+
+
+        /** Return to the neutral defaults, eg before the attached structures are destroyed.
+         */
+        void detach()
+        {
+            useDefaults();
+            m_hashBlocks = 0;
+        }
+
 
         DSP_INLINE uint32_t vcoWaveform(unsigned index) const { return m_main->engine[0].vco[index].waveform; }     ///< Return the VCO waveform: { 0=square, 1=triangle, 2=saw }
         DSP_INLINE uint32_t vcoShape(unsigned index) const { return m_main->engine[0].vco[index].shape; }           ///< Return the current VCO shape: [0, 0x2000]
@@ -51,7 +295,7 @@ namespace logue
 
         // LFO Platform differences.
         //
-        // On Prologue, the LFO runs continuously, with a 32 bit phase and phase delta clocked at kLfoClockHz.
+        // On Prologue, the LFO runs continuously, with a 32 bit phase and phase delta clocked at Platform::kLfoClockHz.
         //
         // On Minilogue, the same is true, but there is an additional one-shot mode for the LFO that causes the
         // phase to run a half-cycle (not a full 360 degree cycle), after which the LFO is rendered inactive until
@@ -66,25 +310,18 @@ namespace logue
         // in the interval [0, 0xffffffff], while in one-shot mode, the phase will increment in the interval
         // [0, 0x7fffffff] and then stop at 0x7fffffff when the LFO is disabled.
         //
+        // The platform policy's kLfoHasOneShot selects the implementation at compile time, so on Prologue these
+        // are constants.
+        //
 
-#if PLATFORM_KORG_PROLOGUE
-        DSP_INLINE bool lfoIsActive() const     { return true; }
-        DSP_INLINE bool lfoIsOneShot() const    { return false; }
-        DSP_INLINE uint32_t lfoPhase() const    { return m_lfo->phaseValue; }
-#elif PLATFORM_KORG_MINILOGUE_XD
-        DSP_INLINE bool lfoIsActive() const     { return bool(m_lfo->active); }
-        DSP_INLINE bool lfoIsOneShot() const    { return bool(m_lfo->mode & 1); }
+        DSP_INLINE bool lfoIsActive() const     { return LfoMode::isActive(*m_lfo); }
+        DSP_INLINE bool lfoIsOneShot() const    { return LfoMode::isOneShot(*m_lfo); }
         DSP_INLINE uint32_t lfoPhase() const
         {
             auto phase = m_lfo->phaseValue;
             if (lfoIsOneShot() && phase >= 0x80000000) phase = 0x7fffffff;
             return phase;
         }
-#else
-        DSP_INLINE bool lfoIsActive() const     { return false; }
-        DSP_INLINE bool lfoIsOneShot() const    { return false; }
-        DSP_INLINE uint32_t lfoPhase() const    { return 0; }
-#endif
 
         // Ranges for the converted EG and AMP velocity values.
         static constexpr const float kEgVelocityMin = 0.0f;
@@ -122,8 +359,45 @@ namespace logue
         {
             // We should really derive this from the hardware timer programming. But in practise the rate appears
             // to be fixed. In future, this method may need to be changed.
-            static_assert(kLfoClockHz > 0.0f, "no LFO clock is defined for this platform");
-            return kLfoClockHz;
+            static_assert(Platform::kLfoClockHz > 0.0f, "no LFO clock is defined for this platform");
+            return Platform::kLfoClockHz;
+        }
+
+
+        /** Capture the values used by the render path. Call once per block.
+         *
+         *  @param  snapshot    Receives the values.
+         *
+         *  The VCO values are written by the firmware's control loop, which does not run while OSC_CYCLE is
+         *  executing, so they are read once. The LFO state is written by the LFO interrupt, which can fire at
+         *  any point. Its phase is read before and after the other LFO fields: if it has changed, an interrupt
+         *  landed in between and the group is re-read. The window is a few cycles against an interrupt period
+         *  of ~4000, so a retry is rare and the retry count is bounded. If the phase delta is zero the phase
+         *  does not move, but then the fields are not changing either.
+         */
+        DSP_INLINE void capture(PanelSnapshot& snapshot) const
+        {
+            for (unsigned index = 0; index != 2; ++index)
+            {
+                const auto& vco = m_main->engine[0].vco[index];
+                snapshot.vcoPitch[index] = vco.pitch;
+                snapshot.vcoShape[index] = uint16_t(vco.shape);
+                snapshot.vcoWaveform[index] = uint8_t(vco.waveform);
+            }
+
+            uint32_t phase;
+            unsigned retries = kCaptureRetries;
+            do
+            {
+                phase = load(m_lfo->phaseValue);
+                snapshot.lfoPhaseDelta = load(m_lfo->phaseDelta);
+                snapshot.lfoWaveform = uint8_t(load(m_lfo->waveform));
+                snapshot.lfoIsOneShot = LfoMode::isOneShot(*m_lfo);
+                snapshot.lfoIsActive = LfoMode::isActive(*m_lfo);
+            } while (phase != load(m_lfo->phaseValue) && --retries);
+
+            if (snapshot.lfoIsOneShot && phase >= 0x80000000) phase = 0x7fffffff;
+            snapshot.lfoPhase = phase;
         }
 
 
@@ -131,124 +405,179 @@ namespace logue
 
     private:
 
-        /** Firmware compatibility check. This will substitute dummy data if the firmware version is
-         *  unknown. While there appears to be a firmware version word, it has not been possible to
-         *  confirm if this is updated on new firmware releases. As a result, a fast checksum is used
-         *  to cover a sufficient range of the firmware to detect potential compatibility changes.
+        /** Firmware compatibility check. The panel reads dummy data until the firmware version is known.
+         *  While there appears to be a firmware version word, it has not been possible to confirm if this is
+         *  updated on new firmware releases. As a result, a fast checksum is used to cover a sufficient range
+         *  of the firmware to detect potential compatibility changes, and the result is looked up in the
+         *  platform's registry of known releases (logue_internals.h). The releases may checksum different
+         *  lengths of flash, so the checksum pauses at the end of each, where it is looked up. Host builds
+         *  have no firmware, and read the defaults until a host tool calls attach(); hashImage() runs the
+         *  same check over an image of the flash.
+         *
+         *  @param  blocks      The maximum number of blocks to add to the checksum.
          */
-        void init()
+        void hashFirmware(unsigned blocks)
         {
-            bool isValid = (m_main != nullptr) && (m_lfo != nullptr) && (m_envelope != nullptr && m_vco != nullptr);
-            if (isValid)
+            // The checksum needs to cover at least the first 12k of flash memory. Run all at once, it must be
+            // quick to avoid triggering a timeout that will itself cause problems with the logue firmware. To
+            // determine the checksum for a new firmware release, use DDEBUG to monitor the output message if
+            // the checksum is not found, then add it to kFirmwareLayouts.
+            const unsigned hashed = Registry::hashBlocks() - m_hashBlocks;
+            const unsigned checkpoint = Registry::nextCheckpoint(hashed);
+            if (blocks > checkpoint - hashed) blocks = checkpoint - hashed;
+            if (blocks == 0) return;
+            const unsigned end = hashed + blocks;
+            m_hashBlocks -= blocks;
+            m_hash = hashFlash(m_hashAddress, m_hash, blocks);
+
+            if (end == checkpoint)
             {
-                // The compile time parameters indicate support. Now calculate a firmware checksum to ensure
-                // run-time compatibility. The checksum needs to cover at least the first 12k of flash memory
-                // and run quickly to avoid triggering a timeout that will itself cause problems with the logue
-                // firmware. To determine the checksum for a new firmware release, use DDEBUG to monitor the
-                // output message if the checksum does not match.
-                register uint32_t r4 asm("r4");
-                register uint32_t r5 asm("r5");
-                register uint32_t r6 asm("r6");
-                register uint32_t r7 asm("r7");
-                register uint32_t r8 asm("r8");
-                register uint32_t r9 asm("r9");
-                register uint32_t r10 asm("r10");
-                register uint32_t r11 asm("r11");
-                auto address = (const uint32_t*)0x08000000u;
-                unsigned blocks = 384;
-                uint32_t hash = 0x1200;
-                do {
-                    // Total cycles per loop ~= 26. Total execution time estimated at 0.11ms.
-                    asm (
-                        "ldmia %[r_addr]!, {r4-r11}\n"
-                        : "=r" (r4), "=r" (r5), "=r" (r6), "=r" (r7), "=r" (r8), "=r" (r9), "=r" (r10), "=r" (r11), [r_addr] "+r" (address)
-                        );
-
-                    uint32_t partial = r4 + r5 + r6 + r7 + r8 + r9 + r10 + r11;         // simple block checksum
-                    hash ^= partial;                                                    // combine with hash
-                    hash ^= hash << 13;                                                 // LFSR based random mixing
-                    hash ^= hash >> 17;                                                 //
-                    hash ^= hash << 5;                                                  //
-                } while (--blocks);
-
-                isValid = (hash == kExpectedFlashHash12k);
+                // The release must also use the structure layout that this build was compiled for.
+                const FirmwareLayout* firmware = Registry::find(m_hash, checkpoint);
+                if (firmware != nullptr && firmware->layout == Platform::kLayout)
+                {
+                    useFirmware(*firmware);
+                    m_hashBlocks = 0;
+                }
 // Uncomment to use DDEBUG to monitor unsupported hash values.
-//                 if (!isValid)
-//                 {
-//                     DDEBUG("PANEL: unsupported firmware", hash);
-//                 }
-            }
-
-            if (!isValid)
-            {
-                // Unrecognised firmware. Fallback to some safe defaults.
-                static MainState      main;
-                static LfoState       lfo;
-                static EnvelopeState  envelope;
-                static VcoStateArray  vco;
-
-                memZeroBytes(&main, sizeof main);
-                memZeroBytes(&lfo, sizeof lfo);
-                memZeroBytes(&envelope, sizeof envelope);
-                memZeroBytes(&vco, sizeof vco);
-
-                main.engine[0].filterCutoffControl = 0x2000;
-                main.egVelocity = 0x2000;
-                main.ampVelocity = 0x1400;
-                main.engine[0].vco[0].pitch = 0;
-                main.engine[0].vco[1].pitch = 0;
-
-                m_main      =   &main;
-                m_lfo       =   &lfo;
-                m_envelope  =   &envelope;
-                m_vco       =   &vco;
+//              else if (m_hashBlocks == 0)
+//              {
+//                  DDEBUG("PANEL: unsupported firmware", m_hash);
+//              }
             }
         }
 
-    private:
 
-        void memZeroBytes(void* address, size_t size)
+        /** Add 32 byte blocks of flash to the checksum.
+         *
+         *  @param  address     The first block. Returns the block after the last.
+         *  @param  hash        The checksum so far.
+         *  @param  blocks      The number of blocks, at least 1.
+         *  @return             The new checksum.
+         */
+#if PLATFORM_HOST
+        static uint32_t hashFlash(const uint32_t*& address, uint32_t hash, unsigned blocks)
+        {
+            do {
+                uint32_t partial = 0;
+                for (unsigned i = 0; i != 8; ++i) partial += *address++;
+                hash = mixHash(hash, partial);
+            } while (--blocks);
+            return hash;
+        }
+#else
+        static uint32_t hashFlash(const uint32_t*& address, uint32_t hash, unsigned blocks)
         {
-            auto ptr = (char*)address;
-            while (size != 0) *ptr++ = 0;
+            register uint32_t r4 asm("r4");
+            register uint32_t r5 asm("r5");
+            register uint32_t r6 asm("r6");
+            register uint32_t r7 asm("r7");
+            register uint32_t r8 asm("r8");
+            register uint32_t r9 asm("r9");
+            register uint32_t r10 asm("r10");
+            register uint32_t r11 asm("r11");
+            do {
+                // Total cycles per loop ~= 26. Total execution time for all blocks estimated at 0.11ms.
+                asm (
+                    "ldmia %[r_addr]!, {r4-r11}\n"
+                    : "=r" (r4), "=r" (r5), "=r" (r6), "=r" (r7), "=r" (r8), "=r" (r9), "=r" (r10), "=r" (r11), [r_addr] "+r" (address)
+                    );
+
+                uint32_t partial = r4 + r5 + r6 + r7 + r8 + r9 + r10 + r11;         // simple block checksum
+                hash = mixHash(hash, partial);
+            } while (--blocks);
+            return hash;
         }
+#endif
 
-    private:
 
-        static const uint32_t FirmwareHashPrologue210       =   0x0eff0f53u;
-        static const uint32_t FirmwareHashMinilogueXD210    =   0x2a6b3685u;
+        /** Combine the sum of one block with the checksum.
+         */
+        static DSP_INLINE uint32_t mixHash(uint32_t hash, uint32_t partial)
+        {
+            hash ^= partial;                                                        // combine with hash
+            hash ^= hash << 13;                                                     // LFSR based random mixing
+            hash ^= hash >> 17;                                                     //
+            hash ^= hash << 5;                                                      //
+            return hash;
+        }
+
 
-#if PLATFORM_KORG_PROLOGUE
-        static const uint32_t kExpectedFlashHash12k =   FirmwareHashPrologue210;
-#elif PLATFORM_KORG_MINILOGUE_XD
-        static const uint32_t kExpectedFlashHash12k =   FirmwareHashMinilogueXD210;
-#else
-        static const uint32_t kExpectedFlashHash12k =   0;
+        /** Switch to the state structures of a recognised release. On the host the addresses are the
+         *  synth's, so the release is only recorded, and the panel keeps its current structures.
+         */
+        void useFirmware(const FirmwareLayout& firmware)
+        {
+            m_firmware  =   &firmware;
+#if !PLATFORM_HOST
+            m_main      =   (const MainState*)uintptr_t(firmware.mainAddress);
+            m_lfo       =   (const LfoState*)uintptr_t(firmware.lfoAddress);
+            m_envelope  =   (const EnvelopeState*)uintptr_t(firmware.envelopeAddress);
+            m_vco       =   (const VcoStateArray*)uintptr_t(firmware.vcoAddress);
 #endif
+        }
 
-    private:
-        const MainState*        m_main          { MainStateAddress };
-        const LfoState*         m_lfo           { LfoStateAddress };
-        const EnvelopeState*    m_envelope      { EnvelopeStateAddress };
-        const VcoStateArray*    m_vco           { VcoStateArrayAddress };
-    };
 
+        /** Point the panel at some safe defaults, used until the firmware is recognised. The defaults are
+         *  constant and shared by every panel, so they cost no RAM per instance and are never written.
+         */
+        void useDefaults()
+        {
+            static const MainState      main        = Platform::mainStateDefaults();
+            static const LfoState       lfo         = {};
+            static const EnvelopeState  envelope    = {};
+            static const VcoStateArray  vco         = {};
+
+            m_main      =   &main;
+            m_lfo       =   &lfo;
+            m_envelope  =   &envelope;
+            m_vco       =   &vco;
+        }
 
+    private:
+
+        typedef PanelLfoMode<LfoState, Platform::kLfoHasOneShot> LfoMode;
+        typedef FirmwareRegistry<Platform> Registry;
 
+        static const unsigned kCaptureRetries = 4;      ///< Maximum LFO read attempts in capture().
+        static const unsigned kValidateBlocks = 16;     ///< Default checksum blocks per validate() call (~420 cycles).
+        static const uint32_t kHashSeed = 0x1200;       ///< The checksum before the first block.
 
+        /** Read a value that may be changed by an interrupt. The volatile access ensures that the
+         *  compiler neither caches nor merges repeated reads.
+         */
+        template <typename T> static DSP_INLINE T load(const T& value) { return *static_cast<const volatile T*>(&value); }
 
+    private:
+        const MainState*        m_main          { nullptr };    // The defaults until the firmware is recognised
+        const LfoState*         m_lfo           { nullptr };
+        const EnvelopeState*    m_envelope      { nullptr };
+        const VcoStateArray*    m_vco           { nullptr };
+        const FirmwareLayout*   m_firmware      { nullptr };    // The recognised release
+#if PLATFORM_HOST
+        const uint32_t*         m_hashAddress   { nullptr };                    // No flash until hashImage()
+        unsigned                m_hashBlocks    { 0 };
 #else
+        const uint32_t*         m_hashAddress   { (const uint32_t*)uintptr_t(kFirmwareHashAddress) };
+        unsigned                m_hashBlocks    { Registry::hashBlocks() };     // Blocks still to checksum
+#endif
+        uint32_t                m_hash          { kHashSeed };
+    };
 
 
 
-    /** Dummy class for unsupported plaforms.
-     */
-    /** Class used to read the current state of the Logues panel controls and modulation parameters.
+
+
+    /** Dummy panel for platforms without panel support (eg NTS-1).
      */
-    class Panel
+    template <typename Platform> class BasicPanel<Platform, false>
     {
     public:
 
+        explicit BasicPanel(PanelValidation validation = PanelValidation::Immediate) { (void)validation; }
+        DSP_INLINE void validate(unsigned blocks = 0)                   { (void)blocks; }
+        DSP_INLINE bool isValidating() const                            { return false; }
+
         DSP_INLINE uint32_t vcoWaveform(unsigned index) const           { (void)index; return 0; }
         DSP_INLINE uint32_t vcoShape(unsigned index) const              { (void)index; return 0; }
         DSP_INLINE int32_t vcoPitch(unsigned index) const               { (void)index; return 0; }
@@ -299,9 +628,26 @@ namespace logue
         DSP_INLINE float ampVelocity() const                            { return 1.0f; }
 
         DSP_INLINE float lfoClock() const                               { return 1.0f; }
+
+        DSP_INLINE void capture(PanelSnapshot& snapshot) const
+        {
+            for (unsigned index = 0; index != 2; ++index)
+            {
+                snapshot.vcoPitch[index] = vcoPitch(index);
+                snapshot.vcoShape[index] = uint16_t(vcoShape(index));
+                snapshot.vcoWaveform[index] = uint8_t(vcoWaveform(index));
+            }
+            snapshot.lfoWaveform = uint8_t(lfoWaveform());
+            snapshot.lfoIsOneShot = lfoIsOneShot();
+            snapshot.lfoIsActive = lfoIsActive();
+            snapshot.lfoPhase = lfoPhase();
+            snapshot.lfoPhaseDelta = lfoPhaseDelta();
+        }
     };
 
-#endif
+
+
+    typedef BasicPanel<Platform> Panel;        ///< The panel for the build's platform.
 
 
 }   // namespace
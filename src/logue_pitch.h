@@ -0,0 +1,91 @@
+/** Compile time pitch tables for Logue.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+
+namespace logue
+{
+    /** Map a Q7.8 pitch (MIDI note number with a 1/256 semitone fine part) to a UQ0.32 phase delta at
+     *  48 kHz. The table holds one entry per semitone and the fine part interpolates linearly between
+     *  them, as osc_w0f_for_note() does in the SDK. The SDK scales the fine part by 1/255 rather than
+     *  1/256, so results differ from it by up to 0.4 cents; here a fine part of 0xff stays below the
+     *  next semitone.
+     *
+     *  The table is generated by the compiler from integer constants, so it costs nothing at OSC_INIT,
+     *  lives in the unit's read-only data (516 bytes) and is identical on every platform. The entries
+     *  are correctly rounded (A4 = 440 Hz), and the interpolation is integer arithmetic, so a given
+     *  pitch produces the same phase delta on the host and on the synth.
+     */
+    class PitchTable
+    {
+    public:
+
+        static const unsigned kNotes = 129;         ///< Notes [0, 128], so that pitch 0x7fff can interpolate.
+
+        /** Return the phase delta for a pitch.
+         *
+         *  @param  pitch       The pitch, Q7.8 [0, 0x7fff].
+         *  @return             The phase delta per sample, UQ0.32.
+         */
+        static uint32_t phaseDelta(uint32_t pitch);
+
+
+        /** Return the phase delta for a whole note, evaluated at compile time.
+         *
+         *  @param  note        The MIDI note number, [0, 131].
+         *  @return             The phase delta per sample, UQ0.32, correctly rounded.
+         */
+        static constexpr uint32_t notePhaseDelta(unsigned note)
+        {
+            // Scale the octave 10 value (with 24 extra fractional bits) down to the note's octave, rounding.
+            return uint32_t((octave10(note % 12) + (1ull << (33 - note / 12))) >> (34 - note / 12));
+        }
+
+
+    private:
+
+        // Phase deltas for notes 120 to 131 (C9 to B9) as UQ0.56, ie 2^56 * 440 * 2^((note-69)/12) / 48000.
+        static constexpr uint64_t octave10(unsigned index)
+        {
+            return  (index ==  0) ? 0x2ca69869d7a6cfull :
+                    (index ==  1) ? 0x2f4e4b3f6068f4ull :
+                    (index ==  2) ? 0x321e68d420e2ffull :
+                    (index ==  3) ? 0x35195867fe3395ull :
+                    (index ==  4) ? 0x3841a5d088bb00ull :
+                    (index ==  5) ? 0x3b9a03a5e57d91ull :
+                    (index ==  6) ? 0x3f254d90d523f0ull :
+                    (index ==  7) ? 0x42e68abbd0b438ull :
+                    (index ==  8) ? 0x46e0f0695218baull :
+                    (index ==  9) ? 0x4b17e4b17e4b18ull :
+                    (index == 10) ? 0x4f8f016988a01bull :
+                                    0x544a17374a564aull;
+        }
+
+        // Compile time generation of the table, { notePhaseDelta(0), ..., notePhaseDelta(kNotes - 1) }.
+        template <unsigned... I> struct Indices {};
+        template <unsigned N, unsigned... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+        template <unsigned... I> struct MakeIndices<0, I...> { typedef Indices<I...> Type; };
+
+        template <typename T> struct Table;
+        template <unsigned... I> struct Table<Indices<I...>>
+        {
+            static constexpr uint32_t values[sizeof... (I)] = { notePhaseDelta(I)... };
+        };
+    };
+
+    template <unsigned... I> constexpr uint32_t PitchTable::Table<PitchTable::Indices<I...>>::values[sizeof... (I)];
+
+    // Defined outside the class, as the table can only be instantiated once the class is complete.
+    DSP_INLINE uint32_t PitchTable::phaseDelta(uint32_t pitch)
+    {
+        DSP_ASSERT(pitch <= 0x7fff);
+        const uint32_t* entry = &Table<MakeIndices<kNotes>::Type>::values[pitch >> 8];
+        const uint32_t fine = pitch & 0xffu;
+        return entry[0] + uint32_t((uint64_t(entry[1] - entry[0]) * fine) >> 8);
+    }
+
+    static_assert(PitchTable::notePhaseDelta(69) == 39370534u, "A4 should be 440 Hz");
+    static_assert(PitchTable::notePhaseDelta(0) == 731558u, "C-1 should be 8.18 Hz");
+
+}   // namespace
@@ -0,0 +1,337 @@
+/** Waveshaping for Logue, antialiased with first-order antiderivatives (ADAA).
+ *
+ *  A static nonlinearity y = f(x) applied to a band-limited signal adds harmonics without limit, and
+ *  those above the Nyquist frequency alias. First-order ADAA replaces f(x[n]) by the mean of f over
+ *  the straight line between the previous and current inputs:
+ *
+ *      y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1])              F the antiderivative of f
+ *
+ *  which is a continuous-time box filter applied before sampling. With the demo oscillator at high
+ *  notes it lowers the aliases by 8 to 10 dB for one antiderivative and one divide per sample, where
+ *  a 4x oversampled shaper evaluates the curve four times and runs a decimation filter. The costs
+ *  are a half sample delay and a high frequency roll-off: for a linear curve it reduces to the
+ *  average of the two inputs, -3 dB at 12 kHz. When the input barely moves, the quotient is
+ *  ill-conditioned and f at the midpoint is used instead.
+ *
+ *  Each curve is a class with two static methods, shape(x) for f and antiderivative(x) for F,
+ *  tabulated at 16 points per unit of input. F is interpolated by cubic Hermite segments with f as
+ *  the slope at each point, so F is continuous with a continuous derivative, which the difference
+ *  quotient needs; f is interpolated linearly for the ill-conditioned case.
+ *
+ *      Curve           f(x)                    Gain range      Memory
+ *      ShapeFold       sin(pi/2 x)             1 to 8          520 byte tables
+ *      ShapeSaturate   tanh(x)                 1 to 16         520 byte tables
+ *
+ *  The sine folder reflects the signal back each time it passes +/-1; with a period of 4 and zero
+ *  mean, both f and F are periodic and one period of table covers any input. The saturator's F,
+ *  log(cosh(x)), is even and is continued as a straight line beyond the table, where tanh is flat.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+#include "logue_smoother.h"
+
+namespace logue
+{
+    /** Interpolation of a tabulated antiderivative: @e F and @e f hold F and f at points @e step apart.
+     */
+    struct ShapeTable
+    {
+        /** Return F between points @e i and @e i + 1, at fraction @e t, by a cubic Hermite segment.
+         */
+        static DSP_INLINE float antiderivative(const float* F, const float* f, uint32_t i, float t, float step)
+        {
+            const float d = F[i + 1] - F[i];
+            const float a = step * f[i];
+            const float b = step * f[i + 1];
+            return F[i] + t * (a + t * ((3.0f * d - 2.0f * a - b) + t * (a + b - 2.0f * d)));
+        }
+
+        /** Return f between points @e i and @e i + 1, at fraction @e t, by linear interpolation.
+         */
+        static DSP_INLINE float shape(const float* f, uint32_t i, float t)
+        {
+            return f[i] + t * (f[i + 1] - f[i]);
+        }
+    };
+
+
+    /** Sine wavefolder. One period, x in [0, 4.0), in 64 intervals.
+     */
+    class ShapeFold
+    {
+    public:
+
+        static constexpr float kMaxGain = 8.0f;
+
+        static DSP_INLINE float shape(float x)
+        {
+            uint32_t i;
+            const float t = position(x, i);
+            return ShapeTable::shape(f(), i, t);
+        }
+
+        static DSP_INLINE float antiderivative(float x)
+        {
+            uint32_t i;
+            const float t = position(x, i);
+            return ShapeTable::antiderivative(F(), f(), i, t, 1.0f / 16.0f);
+        }
+
+    private:
+
+        // The table interval and fraction for x, which must be above -64.
+        static DSP_INLINE float position(float x, uint32_t& i)
+        {
+            const float u = (x + 64.0f) * 16.0f;            // 64 is a whole number of periods
+            const uint32_t n = uint32_t(u);
+            i = n & 63u;
+            return u - float(n);
+        }
+
+        // (2/pi) * (1 - cos(pi/2 * i/16)) for i in [0, 64].
+        static DSP_INLINE const float* F()
+        {
+            static const float table[65] =
+            {
+                 0.000000000f,  0.003065498f,  0.012232470f,  0.027412634f,  0.048459795f,  0.075171258f,
+                 0.107289777f,  0.144506034f,  0.186461614f,  0.232752464f,  0.282932777f,  0.336519289f,
+                 0.392995933f,  0.451818807f,  0.512421416f,  0.574220123f,  0.636619772f,  0.699019422f,
+                 0.760818129f,  0.821420738f,  0.880243612f,  0.936720256f,  0.990306768f,  1.040487081f,
+                 1.086777930f,  1.128733511f,  1.165949768f,  1.198068287f,  1.224779750f,  1.245826911f,
+                 1.261007074f,  1.270174047f,  1.273239545f,  1.270174047f,  1.261007074f,  1.245826911f,
+                 1.224779750f,  1.198068287f,  1.165949768f,  1.128733511f,  1.086777930f,  1.040487081f,
+                 0.990306768f,  0.936720256f,  0.880243612f,  0.821420738f,  0.760818129f,  0.699019422f,
+                 0.636619772f,  0.574220123f,  0.512421416f,  0.451818807f,  0.392995933f,  0.336519289f,
+                 0.282932777f,  0.232752464f,  0.186461614f,  0.144506034f,  0.107289777f,  0.075171258f,
+                 0.048459795f,  0.027412634f,  0.012232470f,  0.003065498f,  0.000000000f,
+            };
+            return table;
+        }
+
+        // sin(pi/2 * i/16) for i in [0, 64].
+        static DSP_INLINE const float* f()
+        {
+            static const float table[65] =
+            {
+                 0.000000000f,  0.098017140f,  0.195090322f,  0.290284677f,  0.382683432f,  0.471396737f,
+                 0.555570233f,  0.634393284f,  0.707106781f,  0.773010453f,  0.831469612f,  0.881921264f,
+                 0.923879533f,  0.956940336f,  0.980785280f,  0.995184727f,  1.000000000f,  0.995184727f,
+                 0.980785280f,  0.956940336f,  0.923879533f,  0.881921264f,  0.831469612f,  0.773010453f,
+                 0.707106781f,  0.634393284f,  0.555570233f,  0.471396737f,  0.382683432f,  0.290284677f,
+                 0.195090322f,  0.098017140f,  0.000000000f, -0.098017140f, -0.195090322f, -0.290284677f,
+                -0.382683432f, -0.471396737f, -0.555570233f, -0.634393284f, -0.707106781f, -0.773010453f,
+                -0.831469612f, -0.881921264f, -0.923879533f, -0.956940336f, -0.980785280f, -0.995184727f,
+                -1.000000000f, -0.995184727f, -0.980785280f, -0.956940336f, -0.923879533f, -0.881921264f,
+                -0.831469612f, -0.773010453f, -0.707106781f, -0.634393284f, -0.555570233f, -0.471396737f,
+                -0.382683432f, -0.290284677f, -0.195090322f, -0.098017140f,  0.000000000f,
+            };
+            return table;
+        }
+    };
+
+
+    /** tanh() saturator. x in [0, 4.0] in 64 intervals, mirrored for negative x.
+     */
+    class ShapeSaturate
+    {
+    public:
+
+        static constexpr float kMaxGain = 16.0f;
+
+        static DSP_INLINE float shape(float x)
+        {
+            const float a = (x < 0.0f) ? -x : x;
+            if (a >= 4.0f) return (x < 0.0f) ? -f()[64] : f()[64];
+            const float u = a * 16.0f;
+            const uint32_t i = uint32_t(u);
+            const float y = ShapeTable::shape(f(), i, u - float(i));
+            return (x < 0.0f) ? -y : y;
+        }
+
+        static DSP_INLINE float antiderivative(float x)
+        {
+            const float a = (x < 0.0f) ? -x : x;
+            if (a >= 4.0f) return F()[64] + (a - 4.0f) * f()[64];
+            const float u = a * 16.0f;
+            const uint32_t i = uint32_t(u);
+            return ShapeTable::antiderivative(F(), f(), i, u - float(i), 1.0f / 16.0f);
+        }
+
+    private:
+
+        // log(cosh(i/16)) for i in [0, 64].
+        static DSP_INLINE const float* F()
+        {
+            static const float table[65] =
+            {
+                 0.000000000f,  0.001951855f,  0.007792239f,  0.017476084f,  0.030929804f,  0.048053498f,
+                 0.068723826f,  0.092797400f,  0.120114507f,  0.150502956f,  0.183781901f,  0.219765471f,
+                 0.258266097f,  0.299097455f,  0.342076970f,  0.387027877f,  0.433780830f,  0.482175098f,
+                 0.532059378f,  0.583292285f,  0.635742554f,  0.689289019f,  0.743820408f,  0.799234999f,
+                 0.855440171f,  0.912351899f,  0.969894191f,  1.027998519f,  1.086603238f,  1.145653015f,
+                 1.205098284f,  1.264894720f,  1.325002747f,  1.385387076f,  1.446016276f,  1.506862390f,
+                 1.567900564f,  1.629108730f,  1.690467303f,  1.751958914f,  1.813568168f,  1.875281428f,
+                 1.937086618f,  1.998973048f,  2.060931263f,  2.122952895f,  2.185030546f,  2.247157676f,
+                 2.309328505f,  2.371537921f,  2.433781413f,  2.496054990f,  2.558355130f,  2.620678720f,
+                 2.683023014f,  2.745385584f,  2.807764286f,  2.870157229f,  2.932562742f,  2.994979350f,
+                 3.057405751f,  3.119840796f,  3.182283469f,  3.244732876f,  3.307188226f,
+            };
+            return table;
+        }
+
+        // tanh(i/16) for i in [0, 64].
+        static DSP_INLINE const float* f()
+        {
+            static const float table[65] =
+            {
+                 0.000000000f,  0.062418747f,  0.124353002f,  0.185333200f,  0.244918662f,  0.302709729f,
+                 0.358357398f,  0.411570056f,  0.462117157f,  0.509829974f,  0.554599722f,  0.596373555f,
+                 0.635148952f,  0.670967074f,  0.703905604f,  0.734071520f,  0.761594156f,  0.786618812f,
+                 0.809301070f,  0.829801910f,  0.848283640f,  0.864906618f,  0.879826700f,  0.893193340f,
+                 0.905148254f,  0.915824544f,  0.925346225f,  0.933828043f,  0.941375538f,  0.948085286f,
+                 0.954045260f,  0.959335293f,  0.964027580f,  0.968187217f,  0.971872746f,  0.975136698f,
+                 0.978026115f,  0.980583047f,  0.982845029f,  0.984845517f,  0.986614298f,  0.988177862f,
+                 0.989559749f,  0.990780856f,  0.991859725f,  0.992812795f,  0.993654634f,  0.994398146f,
+                 0.995054754f,  0.995634567f,  0.996146531f,  0.996598555f,  0.996997635f,  0.997349955f,
+                 0.997660979f,  0.997935538f,  0.998177898f,  0.998391828f,  0.998580659f,  0.998747332f,
+                 0.998894443f,  0.999024286f,  0.999138886f,  0.999240031f,  0.999329300f,
+            };
+            return table;
+        }
+    };
+
+
+    /** First-order ADAA waveshaper, processing a block in place.
+     *
+     *  The input is scaled by a gain set by the drive, [0, 1.0], from 1 up to the curve's kMaxGain. The
+     *  gain ramps linearly across each block, so that drive changes do not step. The curve is selected
+     *  once per block, and each curve has its own fully inlined loop. To shape inside another render
+     *  loop instead, select the curve with curve() and use a Stage for the block.
+     */
+    class AdaaShaper
+    {
+    public:
+
+        static const unsigned Fold = 0;
+        static const unsigned Saturate = 1;
+
+
+        void setCurve(unsigned index)
+        {
+            // index: [0, 1]
+            if (index == m_curveIndex) return;
+            m_curveIndex = index;
+
+            // The cached antiderivative belongs to the old curve.
+            switch (m_curveIndex)
+            {
+                case Fold:          m_F1 = ShapeFold::antiderivative(m_x1);         break;
+                case Saturate:      m_F1 = ShapeSaturate::antiderivative(m_x1);     break;
+                default:            m_F1 = ShapeFold::antiderivative(m_x1);         break;
+            }
+        }
+
+
+        void setDrive(float drive)
+        {
+            // drive: [0.0, 1.0]
+            if (drive < 0.0f) drive = 0.0f;
+            else if (drive > 1.0f) drive = 1.0f;
+            m_drive = drive;
+        }
+
+
+        unsigned curve() const { return m_curveIndex; }       ///< The curve: Fold or Saturate.
+
+
+        /** The shaper for one block, one sample at a time, for the curve selected by @e Curve
+         *  (ShapeFold for Fold, ShapeSaturate for Saturate). It works on a copy of the shaper state, so
+         *  that the calling loop keeps it in registers, and store() writes it back after the block.
+         */
+        template <typename Curve> class Stage
+        {
+        public:
+
+            /** Start a block.
+             *
+             *  @param  shaper      The shaper.
+             *  @param  frames      The number of samples in the block, > 0.
+             */
+            Stage(const AdaaShaper& shaper, unsigned frames) : m_gain(shaper.m_gain), m_x1(shaper.m_x1), m_F1(shaper.m_F1)
+            {
+                m_gain.setTarget(1.0f + shaper.m_drive * (Curve::kMaxGain - 1.0f), frames);
+            }
+
+            void store(AdaaShaper& shaper) const
+            {
+                shaper.m_gain = m_gain;
+                shaper.m_x1 = m_x1;
+                shaper.m_F1 = m_F1;
+            }
+
+            /** Return the shaped value of the next input sample.
+             */
+            DSP_INLINE float tick(float xn)
+            {
+                const float x = m_gain.tick() * xn;
+                const float F = Curve::antiderivative(x);
+                const float dx = x - m_x1;
+                const float y = (dx > kMinStep || dx < -kMinStep) ? (F - m_F1) / dx : Curve::shape(0.5f * (x + m_x1));
+                m_x1 = x;
+                m_F1 = F;
+                return y;
+            }
+
+        private:
+
+            LinearSmoother  m_gain;
+            float           m_x1;
+            float           m_F1;
+        };
+
+
+        /** Shape a block of samples in place.
+         *
+         *  @param  xn          The samples.
+         *  @param  frames      The number of sample frames.
+         */
+        void render(float* xn, unsigned frames)
+        {
+            switch (m_curveIndex)
+            {
+                case Fold:          renderCurve<ShapeFold>(xn, frames);         break;
+                case Saturate:      renderCurve<ShapeSaturate>(xn, frames);     break;
+                default:            renderCurve<ShapeFold>(xn, frames);         break;
+            }
+        }
+
+
+    private:
+
+        // Below this step the difference quotient loses more to rounding than the midpoint loses to
+        // curvature.
+        static constexpr float kMinStep = 1.0e-3f;
+
+
+        template <typename Curve> DSP_INLINE void renderCurve(float* xn, unsigned frames)
+        {
+            Stage<Curve> stage(*this, frames);
+            for (unsigned i = 0; i != frames; ++i)
+            {
+                xn[i] = stage.tick(xn[i]);
+            }
+            stage.store(*this);
+        }
+
+
+    private:
+
+        unsigned        m_curveIndex    { Fold };               // [0, 1]
+        float           m_drive         { 0.0f };               // [0, 1.0]
+        LinearSmoother  m_gain          { 1.0f };               // The input gain, [1.0, Curve::kMaxGain]
+        float           m_x1            { 0.0f };               // The previous input, after the gain
+        float           m_F1            { 0.0f };               // Curve::antiderivative(m_x1)
+    };
+
+}   // namespace
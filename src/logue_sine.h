@@ -0,0 +1,111 @@
+/** Sine approximation kernels for Logue.
+ *
+ *  Each kernel is a class with a single static method, sine(phase), that returns sin(2 * pi * phase)
+ *  for a phase in cycles, [0, 1.0). The kernels trade accuracy for speed and are intended to be
+ *  passed as a template parameter, so the choice is made at compile time with no call overhead.
+ *
+ *      Kernel              Max abs error       Est. M4 cycles      Memory
+ *      SineQuarterTable    7.5e-5 (-82 dB)     ~18                 264 byte table
+ *      SinePoly5           6.8e-5 (-83 dB)     ~14                 -
+ *      SineParabolic       5.6e-2 (-25 dB)     ~6                  -
+ *
+ *  For comparison, the SDK osc_sinf() interpolates a 128 point half-wave table and has an error of
+ *  around 7.5e-5 at ~18 cycles. The errors are measured against double precision sin() across the
+ *  full cycle. The cycle counts are estimated from the instruction sequence (VFP arithmetic, one
+ *  cycle each; vmla three cycles; loads two cycles) and exclude loop overhead. Use the host bench
+ *  tool (sine/...) to compare the kernels on a given machine.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+
+namespace logue
+{
+    /** Quarter-wave table with linear interpolation.
+     *
+     *  The table holds 64 intervals of the first quadrant. The other quadrants are produced by
+     *  mirroring the table index and negating the result.
+     */
+    class SineQuarterTable
+    {
+    public:
+
+        DSP_INLINE static float sine(float phase)
+        {
+            // Table of sin(pi/2 * i/64) for i in [0, 64], plus a guard entry for index 64 with a
+            // fractional part of zero.
+            static const float table[66] =
+            {
+                0.000000000f, 0.024541229f, 0.049067674f, 0.073564564f, 0.098017140f, 0.122410675f,
+                0.146730474f, 0.170961889f, 0.195090322f, 0.219101240f, 0.242980180f, 0.266712757f,
+                0.290284677f, 0.313681740f, 0.336889853f, 0.359895037f, 0.382683432f, 0.405241314f,
+                0.427555093f, 0.449611330f, 0.471396737f, 0.492898192f, 0.514102744f, 0.534997620f,
+                0.555570233f, 0.575808191f, 0.595699304f, 0.615231591f, 0.634393284f, 0.653172843f,
+                0.671558955f, 0.689540545f, 0.707106781f, 0.724247083f, 0.740951125f, 0.757208847f,
+                0.773010453f, 0.788346428f, 0.803207531f, 0.817584813f, 0.831469612f, 0.844853565f,
+                0.857728610f, 0.870086991f, 0.881921264f, 0.893224301f, 0.903989293f, 0.914209756f,
+                0.923879533f, 0.932992799f, 0.941544065f, 0.949528181f, 0.956940336f, 0.963776066f,
+                0.970031253f, 0.975702130f, 0.980785280f, 0.985277642f, 0.989176510f, 0.992479535f,
+                0.995184727f, 0.997290457f, 0.998795456f, 0.999698819f, 1.000000000f, 1.000000000f,
+            };
+
+            const float x = phase * 4.0f;                   // [0, 4.0)
+            const uint32_t quadrant = uint32_t(x) & 3u;
+            float fraction = x - float(quadrant);           // [0, 1.0)
+            if (quadrant & 1u) fraction = 1.0f - fraction;  // (0, 1.0]
+
+            const float position = fraction * 64.0f;
+            const uint32_t index = uint32_t(position);
+            const float y0 = table[index];
+            const float y1 = table[index + 1];
+            const float y = y0 + (position - float(index)) * (y1 - y0);
+            return (quadrant & 2u) ? -y : y;
+        }
+    };
+
+
+    /** Odd 5th-order minimax polynomial, evaluated over a quarter-wave.
+     *
+     *  The phase is folded to x in [-0.25, 0.25] with sin(2 * pi * x) equal to the result, then
+     *  approximated by c1 * x + c3 * x^3 + c5 * x^5. The coefficients are a Remez fit for minimum
+     *  absolute error over the folded range.
+     */
+    class SinePoly5
+    {
+    public:
+
+        DSP_INLINE static float sine(float phase)
+        {
+            const float c1 =   6.28128004f;
+            const float c3 = -41.0952415f;
+            const float c5 =  73.5855179f;
+
+            // sin(2 * pi * phase) = sin(2 * pi * x), with x = 0.5 - phase mirrored into [-0.25, 0.25].
+            float x = 0.5f - phase;                         // (-0.5, 0.5]
+            if (x > 0.25f) x = 0.5f - x;
+            else if (x < -0.25f) x = -0.5f - x;
+
+            const float x2 = x * x;
+            return x * (c1 + x2 * (c3 + x2 * c5));
+        }
+    };
+
+
+    /** Parabolic approximation: two parabolic segments, one per half cycle.
+     *
+     *  This is continuous with a continuous first derivative, but the second derivative steps at
+     *  the zero crossings. Useful where the sine is a modulation source rather than heard directly.
+     */
+    class SineParabolic
+    {
+    public:
+
+        DSP_INLINE static float sine(float phase)
+        {
+            const float x = phase - 0.5f;                   // [-0.5, 0.5)
+            const float ax = (x < 0.0f) ? -x : x;
+            return 8.0f * x * (2.0f * ax - 1.0f);
+        }
+    };
+
+}   // namespace
@@ -0,0 +1,166 @@
+/** Per-sample smoothing of control values for Logue.
+ *
+ *  Control values arrive once per OSC_CYCLE block. Applying them as a constant for the block makes
+ *  them step at the block boundaries, which is audible as zipper noise on gains and modulation
+ *  depths. The smoothers here ramp a value towards its target one sample at a time instead.
+ *
+ *  All smoothers share the same interface, so a render loop can be a template on the smoother type:
+ *
+ *      reset(value)                Jump to a value, with no ramp.
+ *      setTarget(target, frames)   Start a block, ramping towards a new target. Call once per block.
+ *      settled()                   True if the value is constant for the whole block.
+ *      value()                     The value at the start of the next sample.
+ *      tick()                      Return the value for this sample and advance to the next.
+ *
+ *  A render loop should copy the smoother to a local before the loop and back afterwards, so that
+ *  the state stays in registers. When settled() is true, pass SmoothConstant instead: the loop then
+ *  compiles to the unsmoothed code, with no per-sample cost and no per-sample branch.
+ */
+#pragma once
+
+#include "logue_dsp.h"
+
+namespace logue
+{
+    /** A value that does not change over the block: the settled fast path for any smoother.
+     */
+    class SmoothConstant
+    {
+    public:
+
+        explicit SmoothConstant(float value = 0.0f) : m_value(value) {}
+
+        void reset(float value) { m_value = value; }
+        void setTarget(float target, unsigned frames) { (void)frames; m_value = target; }
+        bool settled() const { return true; }
+        float value() const { return m_value; }
+        DSP_INLINE float tick() { return m_value; }
+
+    private:
+
+        float   m_value;
+    };
+
+
+    /** Per-sample values computed ahead of the render loop, eg a control value with audio-rate
+     *  modulation added. Only the read side of the interface applies: settled() is false and tick()
+     *  steps through the array.
+     */
+    class SmoothArray
+    {
+    public:
+
+        explicit SmoothArray(const float* values) : m_values(values) {}
+
+        bool settled() const { return false; }
+        float value() const { return *m_values; }
+        DSP_INLINE float tick() { return *m_values++; }
+
+    private:
+
+        const float*    m_values;
+    };
+
+
+    /** Linear ramp, reaching the target exactly at the end of the block.
+     *
+     *  The response time is one block, whatever the size of the change. This suits values that are
+     *  already smooth at the block rate (eg a panel knob), where the only aim is to remove the step.
+     */
+    class LinearSmoother
+    {
+    public:
+
+        explicit LinearSmoother(float value = 0.0f) : m_value(value), m_target(value), m_step(0.0f) {}
+
+        void reset(float value)
+        {
+            m_value = value;
+            m_target = value;
+            m_step = 0.0f;
+        }
+
+        /** Start a ramp to @e target over the next @e frames calls to tick().
+         *
+         *  @param  target      The target value.
+         *  @param  frames      The number of samples in the block, > 0.
+         */
+        void setTarget(float target, unsigned frames)
+        {
+            DSP_ASSERT(frames > 0);
+
+            // The previous ramp has run for its full length, so snap away the accumulated rounding.
+            m_value = m_target;
+            m_target = target;
+            m_step = (target - m_value) / float(frames);
+        }
+
+        bool settled() const { return m_step == 0.0f; }
+        float value() const { return m_value; }
+
+        DSP_INLINE float tick()
+        {
+            const float y = m_value;
+            m_value = y + m_step;
+            return y;
+        }
+
+    private:
+
+        float   m_value;
+        float   m_target;
+        float   m_step;
+    };
+
+
+    /** One-pole (exponential) lowpass, evaluated per sample.
+     *
+     *  The response time is set by the coefficient and is independent of the block size. Once the
+     *  value is within kSettle of the target it snaps to it, and the smoother reports as settled.
+     */
+    class OnePoleSmoother
+    {
+    public:
+
+        static constexpr float kSettle = 1.0f / 65536.0f;  ///< Snap distance (-96 dB of full scale).
+
+        /** Construct the smoother.
+         *
+         *  @param  coefficient The fraction of the remaining distance covered per sample, (0, 1.0].
+         *                      For a time constant of n samples, use 1 - exp(-1/n).
+         *  @param  value       The initial value.
+         */
+        explicit OnePoleSmoother(float coefficient, float value = 0.0f) : m_value(value), m_target(value), m_coefficient(coefficient) {}
+
+        void reset(float value)
+        {
+            m_value = value;
+            m_target = value;
+        }
+
+        void setTarget(float target, unsigned frames)
+        {
+            (void)frames;
+            m_target = target;
+            const float distance = target - m_value;
+            if ((distance <= kSettle) && (distance >= -kSettle)) m_value = target;
+        }
+
+        bool settled() const { return m_value == m_target; }
+        float value() const { return m_value; }
+
+        DSP_INLINE float tick()
+        {
+            const float y = m_value;
+            m_value = y + (m_target - y) * m_coefficient;
+            return y;
+        }
+
+    private:
+
+        float   m_value;
+        float   m_target;
+        float   m_coefficient;
+    };
+
+}   // namespace
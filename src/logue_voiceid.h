@@ -26,6 +26,12 @@ namespace logue
             hash32(*UniqueId0);
             hash32(*UniqueId1);
             hash32(*UniqueId2);
+#elif PLATFORM_HOST
+            // Host builds have no MCU unique ID. Hash a fixed ID so that renders are reproducible.
+            m_hash = 0x811c9dc5u;       // FN1v basis
+            hash32(0);
+            hash32(0);
+            hash32(0);
 #else
 #warning "Unsupported platform for VoiceID() -- hash will be zero"
             m_hash = 0;
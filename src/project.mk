@@ -6,12 +6,20 @@ PROJECT = panel-demo
 DISPLAY_NAME = demo
 VERSION = 1.0-1
 
+# Oscillator oversampling (see demo_oscillator.h): the factor, 1 (none), 2 or 4, and the decimation
+# filter grade, 0 to 2. Eg 'make OVERSAMPLING=2'. Run 'make clean' first when changing them.
+OVERSAMPLING ?= 1
+OVERSAMPLING_QUALITY ?= 1
+
+# Non-zero to render the two oscillators in one pass (see demo_engine.h). Eg 'make FUSED_MIX=1'.
+FUSED_MIX ?= 0
+
 SRCDIR = ../src
 SDKDIR = ../../../sdk
 
 UCSRC =
 UCXXSRC = $(SRCDIR)/main.cpp
 UINCDIR = ${SRCDIR}
-UDEFS = $(PLATFORM_UDEFS)
+UDEFS = $(PLATFORM_UDEFS) -DDEMO_OVERSAMPLING=$(OVERSAMPLING) -DDEMO_OVERSAMPLING_QUALITY=$(OVERSAMPLING_QUALITY) -DDEMO_FUSED_MIX=$(FUSED_MIX)
 ULIB =
 ULIBDIR =